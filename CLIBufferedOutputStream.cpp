@@ -0,0 +1,181 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIBufferedOutputStream
+ */
+#include "CLIBufferedOutputStream.h"
+#include <string.h>
+
+/**
+	@brief Creates a buffered stream
+
+	@param buf		Ring buffer storage
+	@param size		Size of buf
+	@param crlf		True to translate \n to \r\n (for raw serial ports etc)
+ */
+CLIBufferedOutputStream::CLIBufferedOutputStream(char* buf, size_t size, bool crlf)
+	: m_buf(buf)
+	, m_size(size)
+	, m_tail(0)
+	, m_count(0)
+	, m_highWater(size * 3 / 4)
+	, m_lowWater(size / 4)
+	, m_dropped(0)
+	, m_congested(false)
+	, m_crlf(crlf)
+{
+}
+
+/**
+	@brief Sets the fill levels at which the stream becomes congested, and stops being congested
+
+	The defaults are 3/4 and 1/4 of the buffer size.
+ */
+void CLIBufferedOutputStream::SetWaterMarks(size_t high, size_t low)
+{
+	if(high > m_size)
+		high = m_size;
+	if(low > high)
+		low = high;
+
+	m_highWater = high;
+	m_lowWater = low;
+	UpdateCongestion();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Output
+
+void CLIBufferedOutputStream::PutCharacter(char ch)
+{
+	if(m_crlf && (ch == '\n'))
+		Push('\r');
+	Push(ch);
+	UpdateCongestion();
+}
+
+void CLIBufferedOutputStream::PutString(const char* str)
+{
+	PutData(str, strlen(str));
+}
+
+void CLIBufferedOutputStream::PutData(const char* data, size_t len)
+{
+	for(size_t i=0; i<len; i++)
+	{
+		if(m_crlf && (data[i] == '\n'))
+			Push('\r');
+		Push(data[i]);
+	}
+	UpdateCongestion();
+}
+
+/**
+	@brief Adds one byte to the buffer, making room by draining it if full
+ */
+void CLIBufferedOutputStream::Push(char ch)
+{
+	if( (m_count == m_size) && (Drain() == 0) )
+	{
+		m_dropped ++;
+		return;
+	}
+
+	size_t head = m_tail + m_count;
+	if(head >= m_size)
+		head -= m_size;
+	m_buf[head] = ch;
+	m_count ++;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Draining
+
+/**
+	@brief Sends whatever the transport can take right now, without blocking
+
+	@return Number of bytes sent
+ */
+size_t CLIBufferedOutputStream::Drain()
+{
+	size_t total = 0;
+	while(m_count > 0)
+	{
+		//Send the contiguous run at the tail, which may stop at the end of the buffer
+		size_t chunk = m_size - m_tail;
+		if(chunk > m_count)
+			chunk = m_count;
+
+		size_t sent = WriteToTransport(m_buf + m_tail, chunk);
+		if(sent > chunk)
+			sent = chunk;
+
+		m_tail += sent;
+		if(m_tail == m_size)
+			m_tail = 0;
+		m_count -= sent;
+		total += sent;
+
+		//Transport is full, try again later
+		if(sent < chunk)
+			break;
+	}
+
+	//Keep the buffer contiguous when possible, so the transport gets bigger writes
+	if(m_count == 0)
+		m_tail = 0;
+
+	UpdateCongestion();
+	return total;
+}
+
+/**
+	@brief Starts sending buffered data. Returns immediately; anything the transport can't take stays buffered.
+ */
+void CLIBufferedOutputStream::Flush()
+{
+	Drain();
+}
+
+/**
+	@brief Updates the congestion flag after the fill level changes
+ */
+void CLIBufferedOutputStream::UpdateCongestion()
+{
+	if(!m_congested && (m_count >= m_highWater) && (m_highWater > 0) )
+	{
+		m_congested = true;
+		OnHighWater();
+	}
+	else if(m_congested && (m_count <= m_lowWater) )
+		m_congested = false;
+}
@@ -0,0 +1,144 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIBufferedOutputStream
+ */
+#ifndef CLIBufferedOutputStream_h
+#define CLIBufferedOutputStream_h
+
+#include "CLIOutputStream.h"
+
+/**
+	@brief A CLIOutputStream which queues output in a ring buffer and drains it to the transport without blocking
+
+	Transports only need to implement WriteToTransport(), which hands off as many bytes as the transport can take right
+	now (free space in a UART TX FIFO, SSH channel window, etc) and returns immediately.
+
+	Once the buffer fills past the high water mark the stream reports itself as congested, and stays congested until
+	it drains below the low water mark. CLISessionContext stops consuming input while its stream is congested, so a slow
+	transport throttles the session rather than stalling the main loop.
+
+	If the buffer fills completely and the transport can't take anything, further output is discarded and counted.
+	Size the buffer to hold the largest single command output, plus the high water mark.
+
+	Not interrupt safe: if Drain() is called from a TX interrupt, the caller must mask it while writing.
+ */
+class CLIBufferedOutputStream : public CLIOutputStream
+{
+public:
+	CLIBufferedOutputStream(char* buf, size_t size, bool crlf);
+
+	virtual void PutCharacter(char ch) override;
+	virtual void PutString(const char* str) override;
+	virtual void PutData(const char* data, size_t len) override;
+	virtual void Flush() override;
+	virtual bool IsCongested() override
+	{ return m_congested; }
+
+	size_t Drain();
+	void SetWaterMarks(size_t high, size_t low);
+
+	///@brief Returns the number of bytes waiting to be sent
+	size_t GetPending() const
+	{ return m_count; }
+
+	///@brief Returns the number of bytes discarded because the buffer was full
+	size_t GetDroppedCount() const
+	{ return m_dropped; }
+
+protected:
+
+	/**
+		@brief Sends as much of a block of data as the transport can take, without blocking
+
+		@return Number of bytes accepted, which may be zero
+	 */
+	virtual size_t WriteToTransport(const char* data, size_t len) =0;
+
+	/**
+		@brief Called when the buffer fills past the high water mark
+
+		The default implementation does nothing. Transports may use it to kick off a transmission, enable a TX
+		interrupt, etc.
+	 */
+	virtual void OnHighWater()
+	{}
+
+	void Push(char ch);
+	void UpdateCongestion();
+
+	///@brief Ring buffer storage
+	char* m_buf;
+
+	///@brief Size of m_buf
+	size_t m_size;
+
+	///@brief Index of the oldest byte not yet sent
+	size_t m_tail;
+
+	///@brief Number of bytes in the buffer
+	size_t m_count;
+
+	///@brief Fill level at which we become congested
+	size_t m_highWater;
+
+	///@brief Fill level at which we stop being congested
+	size_t m_lowWater;
+
+	///@brief Number of bytes discarded due to a full buffer
+	size_t m_dropped;
+
+	///@brief True if we're between the high and low water marks on the way down
+	bool m_congested;
+
+	///@brief True to translate \n to \r\n
+	bool m_crlf;
+};
+
+/**
+	@brief A CLIBufferedOutputStream with statically allocated storage
+
+	@tparam SIZE	Size of the ring buffer, in bytes
+ */
+template<size_t SIZE>
+class CLIBufferedOutputStreamStorage : public CLIBufferedOutputStream
+{
+public:
+	CLIBufferedOutputStreamStorage(bool crlf = true)
+	: CLIBufferedOutputStream(m_storage, SIZE, crlf)
+	{}
+
+protected:
+	char m_storage[SIZE];
+};
+
+#endif
@@ -0,0 +1,137 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+/**
+	@file
+	@brief Implementation of CLICommand
+ */
+#include "CLICommand.h"
+
+/**
+	@brief Splits text into tokens at spaces, without modifying it
+
+	The tokens are not null terminated. Leading, trailing, and consecutive spaces are ignored.
+
+	@return False if there were more than GetMaxTokens() tokens (the extra ones are dropped)
+ */
+bool CLICommand::Split(const char* text, size_t len)
+{
+	Clear();
+
+	size_t i = 0;
+	while(true)
+	{
+		//Skip whitespace before the token
+		while( (i < len) && (text[i] == ' ') )
+			i ++;
+		if(i >= len)
+			break;
+
+		//Out of space?
+		if(m_tokenCount >= m_maxTokens)
+			return false;
+
+		//Find the end of the token
+		size_t start = i;
+		while( (i < len) && (text[i] != ' ') )
+			i ++;
+
+		CLIToken& token = m_tokens[m_tokenCount ++];
+		token.m_text = text + start;
+		token.m_length = i - start;
+		token.m_commandID = INVALID_COMMAND;
+		token.m_epoch = m_epoch;
+	}
+
+	return true;
+}
+
+/**
+	@brief Splits text into tokens at spaces, null terminating each token in place
+
+	@param text		Text to split. Must be null terminated, i.e. text[len] must be valid.
+	@param len		Length of the text
+
+	@return False if there were more than GetMaxTokens() tokens (the extra ones are dropped)
+ */
+bool CLICommand::Tokenize(char* text, size_t len)
+{
+	bool ok = Split(text, len);
+	m_base = text;
+
+	//The character after each token is either a space or the end of the string
+	for(int i=0; i<m_tokenCount; i++)
+		text[(m_tokens[i].m_text - text) + m_tokens[i].m_length] = '\0';
+
+	return ok;
+}
+
+/**
+	@brief Merges a token with all of the tokens after it, for arguments which consume the rest of the line
+
+	The text between tokens is kept as typed. Only valid after Tokenize().
+ */
+void CLICommand::JoinTokens(int i)
+{
+	if( (m_base == NULL) || (i >= (m_tokenCount - 1)) )
+		return;
+
+	//Put back the spaces we overwrote with nulls
+	for(int j=i; j<(m_tokenCount - 1); j++)
+		m_base[(m_tokens[j].m_text - m_base) + m_tokens[j].m_length] = ' ';
+
+	CLIToken& last = m_tokens[m_tokenCount - 1];
+	m_tokens[i].m_length = (last.m_text + last.m_length) - m_tokens[i].m_text;
+
+	for(int j=i+1; j<m_tokenCount; j++)
+		m_tokens[j].Clear();
+	m_tokenCount = i + 1;
+}
+
+/**
+	@brief Appends a token which has already been matched, for commands which don't come from a line of text
+
+	@param text		Text of the token, which must outlive the command
+	@param len		Length of text
+	@param id		Command ID of the token
+
+	@return False if the command is already full
+ */
+bool CLICommand::AddToken(const char* text, uint16_t len, uint16_t id)
+{
+	if(m_tokenCount >= m_maxTokens)
+		return false;
+
+	auto& tok = m_tokens[m_tokenCount++];
+	tok.m_text = text;
+	tok.m_length = len;
+	tok.m_commandID = id;
+	tok.m_epoch = m_epoch;
+	return true;
+}
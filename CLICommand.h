@@ -36,17 +36,34 @@
 
 #ifndef MAX_TOKENS_PER_COMMAND
 
-	///@brief Maximum number of tokens in a command
+	///@brief Default maximum number of tokens in a command (see CLICommandStorage)
 	#define MAX_TOKENS_PER_COMMAND 8
 
 #endif
 
+#include <stddef.h>
 #include "CLIToken.h"
 
+/**
+	@brief A command line, broken up into tokens
+
+	The tokens point into a line of text owned by someone else (normally a CLILineBuffer), and are only valid as long
+	as that text is.
+
+	The token array is provided by the caller, normally through CLICommandStorage.
+
+	Clearing the command is O(1): it bumps an epoch counter, and tokens are lazily cleared the next time they're
+	accessed if they were last cleared or set in an older epoch.
+ */
 class CLICommand
 {
 public:
-	CLICommand()
+	CLICommand(CLIToken* tokens, int maxTokens)
+	: m_tokens(tokens)
+	, m_maxTokens(maxTokens)
+	, m_base(NULL)
+	, m_tokenCount(0)
+	, m_epoch(0)
 	{
 
 	}
@@ -56,17 +73,79 @@ public:
 	 */
 	void Clear()
 	{
-		for(int i=0; i<MAX_TOKENS_PER_COMMAND; i++)
-			m_tokens[i].Clear();
+		m_tokenCount = 0;
+		m_base = NULL;
+		m_epoch ++;
+
+		//When the epoch wraps, tokens last touched exactly 256 clears ago would look current.
+		//Clear everything for real to avoid that.
+		if(m_epoch == 0)
+		{
+			for(int i=0; i<m_maxTokens; i++)
+			{
+				m_tokens[i].Clear();
+				m_tokens[i].m_epoch = 0;
+			}
+		}
 	}
 
 	CLIToken& operator[](size_t i)
-	{ return m_tokens[i]; }
+	{
+		CLIToken& token = m_tokens[i];
+		if(token.m_epoch != m_epoch)
+		{
+			token.Clear();
+			token.m_epoch = m_epoch;
+		}
+		return token;
+	}
+
+	///@brief Returns the number of non-empty tokens in the command
+	int GetTokenCount() const
+	{ return m_tokenCount; }
+
+	///@brief Returns the largest number of tokens the command can hold
+	int GetMaxTokens() const
+	{ return m_maxTokens; }
+
+	bool Split(const char* text, size_t len);
+	bool Tokenize(char* text, size_t len);
+	void JoinTokens(int i);
+	bool AddToken(const char* text, uint16_t len, uint16_t id);
 
 protected:
 
 	///@brief The tokens
-	CLIToken m_tokens[MAX_TOKENS_PER_COMMAND];
+	CLIToken* m_tokens;
+
+	///@brief Number of entries in m_tokens
+	int m_maxTokens;
+
+	///@brief The text the tokens were split from, if it was tokenized in place
+	char* m_base;
+
+	///@brief Number of tokens in use
+	int m_tokenCount;
+
+	///@brief Incremented every time the command is cleared
+	uint8_t m_epoch;
+};
+
+/**
+	@brief A CLICommand with statically allocated tokens
+
+	@tparam TOKENS	Maximum number of tokens in the command
+ */
+template<int TOKENS = MAX_TOKENS_PER_COMMAND>
+class CLICommandStorage : public CLICommand
+{
+public:
+	CLICommandStorage()
+	: CLICommand(m_storage, TOKENS)
+	{}
+
+protected:
+	CLIToken m_storage[TOKENS];
 };
 
 #endif
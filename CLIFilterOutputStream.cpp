@@ -0,0 +1,238 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIFilterOutputStream
+ */
+#include "CLIFilterOutputStream.h"
+#include <string.h>
+
+/**
+	@brief Looks up a filter by name, or any abbreviation of it
+
+	@param name		The name, as typed after the pipe
+	@param len		Length of name
+	@param mode		The filter, if found
+
+	@return True if the name was recognized
+ */
+bool CLIFilterOutputStream::ParseMode(const char* name, uint16_t len, clifiltermode_t& mode)
+{
+	static const struct
+	{
+		const char*		name;
+		clifiltermode_t	mode;
+	} filters[] =
+	{
+		{"begin",	FILTER_BEGIN},
+		{"count",	FILTER_COUNT},
+		{"exclude",	FILTER_EXCLUDE},
+		{"include",	FILTER_INCLUDE}
+	};
+
+	//The names all start with different letters, so any prefix is unambiguous
+	if(len == 0)
+		return false;
+	for(auto& f : filters)
+	{
+		if( (len <= strlen(f.name)) && (strncmp(name, f.name, len) == 0) )
+		{
+			mode = f.mode;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+	@brief Sets up the filter for the next command
+
+	@param mode		What to do with each line
+	@param pattern	Substring to look for in each line. Must stay valid until End().
+	@param len		Length of pattern
+ */
+void CLIFilterOutputStream::SetFilter(clifiltermode_t mode, const char* pattern, uint16_t len)
+{
+	m_mode = mode;
+	m_pattern = pattern;
+	m_patternLen = len;
+}
+
+/**
+	@brief Starts filtering a command's output
+
+	@param stream	Where to send the lines which get through
+ */
+void CLIFilterOutputStream::Begin(CLIOutputStream* stream)
+{
+	m_stream = stream;
+	m_len = 0;
+	m_lineState = LINE_BUFFERING;
+	m_count = 0;
+}
+
+/**
+	@brief Finishes filtering a command's output, including any final line without a newline
+
+	For FILTER_COUNT, this is when the count is printed. The filter is turned off afterwards.
+ */
+void CLIFilterOutputStream::End()
+{
+	if( (m_lineState == LINE_BUFFERING) && (m_len > 0) )
+		EndOfLine();
+
+	if(m_mode == FILTER_COUNT)
+		m_stream->Printf("%d lines\n", m_count);
+
+	m_mode = FILTER_NONE;
+	m_stream = nullptr;
+}
+
+void CLIFilterOutputStream::PutCharacter(char ch)
+{
+	PutData(&ch, 1);
+}
+
+void CLIFilterOutputStream::PutString(const char* str)
+{
+	PutData(str, strlen(str));
+}
+
+void CLIFilterOutputStream::PutData(const char* data, size_t len)
+{
+	while(len > 0)
+	{
+		//Once "begin" has matched, everything else goes straight through
+		if( (m_mode == FILTER_BEGIN) && (m_lineState == LINE_PASS) )
+		{
+			m_stream->PutData(data, len);
+			return;
+		}
+
+		//Handle everything up to the end of the current line
+		auto eol = static_cast<const char*>(memchr(data, '\n', len));
+		size_t n = eol ? (eol - data) : len;
+
+		switch(m_lineState)
+		{
+			case LINE_PASS:
+				m_stream->PutData(data, eol ? n + 1 : n);
+				break;
+
+			case LINE_DROP:
+				break;
+
+			case LINE_BUFFERING:
+				{
+					//If the line doesn't fit, decide what to do with it based on what does
+					size_t space = m_size - m_len;
+					if(n >= space)
+					{
+						memcpy(m_buf + m_len, data, space);
+						m_len += space;
+						data += space;
+						len -= space;
+						m_lineState = EndOfLine() ? LINE_PASS : LINE_DROP;
+						continue;
+					}
+
+					memcpy(m_buf + m_len, data, n);
+					m_len += n;
+					if(eol && EndOfLine())
+					{
+						m_stream->PutCharacter('\n');
+
+						if(m_mode == FILTER_BEGIN)
+							m_lineState = LINE_PASS;
+					}
+				}
+				break;
+		}
+
+		//Start a new line after the newline
+		if(!eol)
+			return;
+		if(m_lineState == LINE_DROP)
+			m_lineState = LINE_BUFFERING;
+		else if( (m_lineState == LINE_PASS) && (m_mode != FILTER_BEGIN) )
+			m_lineState = LINE_BUFFERING;
+		data += n + 1;
+		len -= n + 1;
+	}
+}
+
+/**
+	@brief Decides what to do with the buffered line, passes it on if it's wanted, and empties the buffer
+
+	@return True if the line (and the rest of it, if it didn't fit) is wanted
+ */
+bool CLIFilterOutputStream::EndOfLine()
+{
+	bool match = Matches();
+	bool pass;
+	switch(m_mode)
+	{
+		case FILTER_EXCLUDE:
+			pass = !match;
+			break;
+
+		case FILTER_COUNT:
+			if(match)
+				m_count ++;
+			pass = false;
+			break;
+
+		default:
+			pass = match;
+			break;
+	}
+
+	if(pass)
+		m_stream->PutData(m_buf, m_len);
+	m_len = 0;
+	return pass;
+}
+
+/**
+	@brief Returns true if the buffered line contains the pattern
+ */
+bool CLIFilterOutputStream::Matches() const
+{
+	if(m_patternLen > m_len)
+		return false;
+
+	for(uint16_t i = 0; i + m_patternLen <= m_len; i++)
+	{
+		if(memcmp(m_buf + i, m_pattern, m_patternLen) == 0)
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,182 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIFilterOutputStream
+ */
+#ifndef CLIFilterOutputStream_h
+#define CLIFilterOutputStream_h
+
+#include <stdint.h>
+#include "CLIOutputStream.h"
+
+#ifndef CLI_FILTER_LINE_LEN
+
+	///@brief Default number of characters of each output line a CLIFilterOutputStreamStorage can match against
+	#define CLI_FILTER_LINE_LEN 128
+
+#endif
+
+/**
+	@brief What a pipe filter ("show foo | include bar") does with each line of output
+ */
+enum clifiltermode_t
+{
+	///@brief Not filtering
+	FILTER_NONE,
+
+	///@brief Only lines containing the pattern are output
+	FILTER_INCLUDE,
+
+	///@brief Only lines not containing the pattern are output
+	FILTER_EXCLUDE,
+
+	///@brief Output starts at the first line containing the pattern
+	FILTER_BEGIN,
+
+	///@brief Nothing is output, but lines containing the pattern (or all lines, if there's no pattern) are counted
+	FILTER_COUNT
+};
+
+/**
+	@brief A CLIOutputStream which passes only some lines of a command's output on to another stream
+
+	CLISessionContext puts this between a command and the session's output stream when the command line ends in a pipe
+	filter (see CLISessionContext::SetFilter()), so lines which are filtered out never reach the transport.
+
+	Each line is held in a fixed size buffer until its end, then passed on or dropped. Patterns are plain substrings,
+	and lines longer than the buffer are matched on the part that fits.
+
+	The buffer is provided by the caller, normally through CLIFilterOutputStreamStorage.
+ */
+class CLIFilterOutputStream : public CLIOutputStream
+{
+public:
+	CLIFilterOutputStream(char* buf, uint16_t size)
+	: m_stream(nullptr)
+	, m_buf(buf)
+	, m_size(size)
+	, m_len(0)
+	, m_mode(FILTER_NONE)
+	, m_pattern(nullptr)
+	, m_patternLen(0)
+	, m_lineState(LINE_BUFFERING)
+	, m_count(0)
+	{}
+
+	static bool ParseMode(const char* name, uint16_t len, clifiltermode_t& mode);
+
+	void SetFilter(clifiltermode_t mode, const char* pattern, uint16_t len);
+
+	///@brief Turns the filter off
+	void ClearFilter()
+	{ m_mode = FILTER_NONE; }
+
+	///@brief Returns true if a filter has been set
+	bool IsEnabled() const
+	{ return m_mode != FILTER_NONE; }
+
+	void Begin(CLIOutputStream* stream);
+	void End();
+
+	virtual void PutCharacter(char ch) override;
+	virtual void PutString(const char* str) override;
+	virtual void PutData(const char* data, size_t len) override;
+
+	virtual void Flush() override
+	{ m_stream->Flush(); }
+
+	virtual bool IsCongested() override
+	{ return m_stream->IsCongested(); }
+
+	virtual void Disconnect() override
+	{ m_stream->Disconnect(); }
+
+protected:
+	bool Matches() const;
+	bool EndOfLine();
+
+	///@brief The stream lines are passed on to (only valid between Begin() and End())
+	CLIOutputStream* m_stream;
+
+	///@brief The current line
+	char* m_buf;
+
+	///@brief Size of m_buf
+	uint16_t m_size;
+
+	///@brief Number of characters in m_buf
+	uint16_t m_len;
+
+	///@brief What to do with each line
+	clifiltermode_t m_mode;
+
+	///@brief The pattern (not null terminated)
+	const char* m_pattern;
+
+	///@brief Length of m_pattern
+	uint16_t m_patternLen;
+
+	///@brief What happens to the rest of the current line
+	enum
+	{
+		///@brief Not decided yet, characters go into m_buf
+		LINE_BUFFERING,
+
+		///@brief Passed straight through (after a match on the start of a long line, or after "begin" matched)
+		LINE_PASS,
+
+		///@brief Dropped
+		LINE_DROP
+	} m_lineState;
+
+	///@brief Number of matching lines, for FILTER_COUNT
+	uint32_t m_count;
+};
+
+/**
+	@brief A CLIFilterOutputStream with a statically allocated line buffer
+
+	@tparam LEN		Number of characters of each line which are matched against the pattern
+ */
+template<uint16_t LEN = CLI_FILTER_LINE_LEN>
+class CLIFilterOutputStreamStorage : public CLIFilterOutputStream
+{
+public:
+	CLIFilterOutputStreamStorage()
+	: CLIFilterOutputStream(m_storage, LEN)
+	{}
+
+protected:
+	char m_storage[LEN];
+};
+
+#endif
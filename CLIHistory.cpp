@@ -0,0 +1,297 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIHistory
+ */
+#include "CLIHistory.h"
+#include "CLILineBuffer.h"
+
+///@brief Longest entry we can store, limited by the two byte length header
+#define MAX_HISTORY_ENTRY 0x7fff
+
+///@brief Returns true if a character separates words, in text passed to AddWords()
+static bool IsSeparator(char c)
+{ return (c == ' ') || (c == '\0'); }
+
+///@brief Returns true if text[i] is left out of the entry, because it continues a run of separators
+static bool IsSkipped(const char* text, size_t i, bool words)
+{ return words && (i > 0) && IsSeparator(text[i]) && IsSeparator(text[i-1]); }
+
+///@brief Returns the character stored in the entry for text[i], if it isn't skipped
+static char EntryCharacter(const char* text, size_t i, bool words)
+{ return (words && IsSeparator(text[i])) ? ' ' : text[i]; }
+
+CLIHistory::CLIHistory(char* buf, size_t size)
+	: m_buf(buf)
+	, m_size(size)
+{
+	Clear();
+}
+
+/**
+	@brief Removes all entries
+ */
+void CLIHistory::Clear()
+{
+	m_start = 0;
+	m_used = 0;
+	m_newest = 0;
+	m_count = 0;
+}
+
+/**
+	@brief Adds a command to the history
+
+	Empty commands, and commands identical to the most recent entry, are ignored.
+ */
+void CLIHistory::Add(const char* text, size_t len)
+{
+	AddEntry(text, len, false);
+}
+
+/**
+	@brief Adds the words of a command to the history, separated by single spaces
+
+	Runs of spaces and nulls separate words, so a line split in place by CLICommand::Tokenize() can be added as it is,
+	and the entry is the same no matter how the line was spaced. Empty commands, and commands identical to the most
+	recent entry, are ignored.
+ */
+void CLIHistory::AddWords(const char* text, size_t len)
+{
+	//Trim both ends, so every remaining run of separators is between two words
+	while( (len > 0) && IsSeparator(text[0]) )
+	{
+		text ++;
+		len --;
+	}
+	while( (len > 0) && IsSeparator(text[len - 1]) )
+		len --;
+
+	AddEntry(text, len, true);
+}
+
+/**
+	@brief Adds an entry, optionally collapsing each run of separators to a single space
+
+	@param text		The command
+	@param len		Length of text
+	@param words	True to collapse separators (see AddWords())
+ */
+void CLIHistory::AddEntry(const char* text, size_t len, bool words)
+{
+	size_t entryLen = 0;
+	for(size_t i=0; i<len; i++)
+	{
+		if(!IsSkipped(text, i, words))
+			entryLen ++;
+	}
+
+	if( (entryLen == 0) || (entryLen > MAX_HISTORY_ENTRY) )
+		return;
+	if( (m_count > 0) && Matches(m_newest, text, len, entryLen, words) )
+		return;
+
+	size_t header = (entryLen < 0x80) ? 1 : 2;
+	size_t needed = header + entryLen;
+	if(needed > m_size)
+		return;
+
+	//Discard old entries until there's room
+	while(m_size - m_used < needed)
+	{
+		size_t oldLen;
+		size_t oldSize = ReadHeader(m_start, oldLen) + oldLen;
+		m_start = Wrap(m_start + oldSize);
+		m_used -= oldSize;
+		m_count --;
+	}
+
+	//Append the new one
+	size_t off = Wrap(m_start + m_used);
+	m_newest = off;
+	if(header == 1)
+		m_buf[off] = entryLen;
+	else
+	{
+		m_buf[off] = 0x80 | (entryLen >> 8);
+		off = Wrap(off + 1);
+		m_buf[off] = entryLen & 0xff;
+	}
+	off = Wrap(off + 1);
+	for(size_t i=0; i<len; i++)
+	{
+		if(IsSkipped(text, i, words))
+			continue;
+		m_buf[off] = EntryCharacter(text, i, words);
+		off = Wrap(off + 1);
+	}
+
+	m_used += needed;
+	m_count ++;
+}
+
+/**
+	@brief Copies an entry out of the history
+
+	@param age		Which entry to get (0 is the most recent)
+	@param text		Buffer for the text, which is not null terminated
+	@param maxlen	Size of the buffer. Longer entries are truncated.
+
+	@return Number of characters copied, or zero if there's no such entry
+ */
+size_t CLIHistory::Get(uint16_t age, char* text, size_t maxlen) const
+{
+	if(age >= m_count)
+		return 0;
+
+	size_t len;
+	size_t off = FindEntry(age);
+	off = Wrap(off + ReadHeader(off, len));
+	if(len > maxlen)
+		len = maxlen;
+
+	for(size_t i=0; i<len; i++)
+	{
+		text[i] = m_buf[off];
+		off = Wrap(off + 1);
+	}
+	return len;
+}
+
+/**
+	@brief Replaces the contents of a line with an entry from the history, leaving the cursor at the end
+
+	@param age		Which entry to get (0 is the most recent)
+	@param line		The line. Entries longer than its capacity are truncated.
+
+	@return Number of characters copied, or zero if there's no such entry (in which case the line is left empty)
+ */
+size_t CLIHistory::Get(uint16_t age, CLILineBuffer& line) const
+{
+	line.Clear();
+	if(age >= m_count)
+		return 0;
+
+	size_t len;
+	size_t off = FindEntry(age);
+	off = Wrap(off + ReadHeader(off, len));
+
+	size_t i = 0;
+	for(; (i < len) && line.Insert(m_buf[off]); i++)
+		off = Wrap(off + 1);
+	return i;
+}
+
+/**
+	@brief Returns the number of characters at the start of an entry which are the same as some text
+
+	@param age		Which entry to compare against (0 is the most recent)
+	@param text		The text
+	@param len		Length of text
+
+	@return Length of the common prefix, or zero if there's no such entry
+ */
+size_t CLIHistory::GetCommonPrefix(uint16_t age, const char* text, size_t len) const
+{
+	if(age >= m_count)
+		return 0;
+
+	size_t entryLen;
+	size_t off = FindEntry(age);
+	off = Wrap(off + ReadHeader(off, entryLen));
+	if(len > entryLen)
+		len = entryLen;
+
+	size_t i = 0;
+	for(; (i < len) && (m_buf[off] == text[i]); i++)
+		off = Wrap(off + 1);
+	return i;
+}
+
+/**
+	@brief Reads the length of the entry at the specified offset
+
+	@return Size of the header, in bytes
+ */
+size_t CLIHistory::ReadHeader(size_t offset, size_t& len) const
+{
+	uint8_t b = m_buf[offset];
+	if(b < 0x80)
+	{
+		len = b;
+		return 1;
+	}
+
+	len = ( (b & 0x7f) << 8) | static_cast<uint8_t>(m_buf[Wrap(offset + 1)]);
+	return 2;
+}
+
+/**
+	@brief Returns the offset of an entry, walking forward from the oldest one
+ */
+size_t CLIHistory::FindEntry(uint16_t age) const
+{
+	size_t off = m_start;
+	for(uint16_t i = m_count - 1; i > age; i--)
+	{
+		size_t len;
+		off = Wrap(off + ReadHeader(off, len) + len);
+	}
+	return off;
+}
+
+/**
+	@brief Returns true if the entry at the specified offset has the same text
+
+	@param offset	Offset of the entry
+	@param text		The text
+	@param len		Length of text
+	@param entryLen	Length text would have as an entry
+	@param words	True to collapse separators in text (see AddWords())
+ */
+bool CLIHistory::Matches(size_t offset, const char* text, size_t len, size_t entryLen, bool words) const
+{
+	size_t oldLen;
+	size_t off = Wrap(offset + ReadHeader(offset, oldLen));
+	if(oldLen != entryLen)
+		return false;
+
+	for(size_t i=0; i<len; i++)
+	{
+		if(IsSkipped(text, i, words))
+			continue;
+		if(m_buf[off] != EntryCharacter(text, i, words))
+			return false;
+		off = Wrap(off + 1);
+	}
+	return true;
+}
@@ -0,0 +1,110 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIHistory
+ */
+#ifndef CLIHistory_h
+#define CLIHistory_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+class CLILineBuffer;
+
+/**
+	@brief Command history, packed into a fixed size ring buffer
+
+	Each entry is the command text, prefixed by its length (one byte if under 128 characters, two bytes otherwise).
+	When the buffer fills up the oldest entries are discarded to make room.
+ */
+class CLIHistory
+{
+public:
+	CLIHistory(char* buf, size_t size);
+
+	void Clear();
+	void Add(const char* text, size_t len);
+	void AddWords(const char* text, size_t len);
+	size_t Get(uint16_t age, char* text, size_t maxlen) const;
+	size_t Get(uint16_t age, CLILineBuffer& line) const;
+	size_t GetCommonPrefix(uint16_t age, const char* text, size_t len) const;
+
+	///@brief Returns the number of entries currently stored
+	uint16_t GetCount() const
+	{ return m_count; }
+
+protected:
+	size_t Wrap(size_t offset) const
+	{ return (offset >= m_size) ? offset - m_size : offset; }
+
+	size_t ReadHeader(size_t offset, size_t& len) const;
+	size_t FindEntry(uint16_t age) const;
+	void AddEntry(const char* text, size_t len, bool words);
+	bool Matches(size_t offset, const char* text, size_t len, size_t entryLen, bool words) const;
+
+	///@brief Ring buffer storage
+	char* m_buf;
+
+	///@brief Size of m_buf
+	size_t m_size;
+
+	///@brief Offset of the oldest entry
+	size_t m_start;
+
+	///@brief Number of bytes in use
+	size_t m_used;
+
+	///@brief Offset of the newest entry
+	size_t m_newest;
+
+	///@brief Number of entries
+	uint16_t m_count;
+};
+
+/**
+	@brief A CLIHistory with statically allocated storage
+
+	@tparam SIZE	Size of the ring buffer, in bytes. Each entry takes its length plus one or two bytes.
+ */
+template<size_t SIZE>
+class CLIHistoryStorage : public CLIHistory
+{
+public:
+	CLIHistoryStorage()
+	: CLIHistory(m_storage, SIZE)
+	{}
+
+protected:
+	char m_storage[SIZE];
+};
+
+#endif
@@ -0,0 +1,161 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIInputQueue
+ */
+#include "CLIInputQueue.h"
+#include "CLISessionContext.h"
+
+/**
+	@brief Creates an empty queue
+
+	@param buf		Storage for the queue
+	@param size		Size of buf, must be a power of two
+ */
+CLIInputQueue::CLIInputQueue(char* buf, uint32_t size)
+	: m_buf(buf)
+	, m_mask(size - 1)
+	, m_head(0)
+	, m_tail(0)
+	, m_overflows(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Producer side
+
+/**
+	@brief Adds one byte to the queue. Safe to call from an interrupt.
+
+	@return False if the queue was full and the byte was dropped
+ */
+bool CLIInputQueue::Push(char c)
+{
+	uint32_t head = m_head.load(std::memory_order_relaxed);
+	uint32_t tail = m_tail.load(std::memory_order_acquire);
+	if(head - tail > m_mask)
+	{
+		m_overflows.store(m_overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	m_buf[head & m_mask] = c;
+	m_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+/**
+	@brief Adds a block of bytes to the queue. Safe to call from an interrupt.
+
+	@return Number of bytes added. Anything that didn't fit is dropped.
+ */
+size_t CLIInputQueue::Push(const char* data, size_t len)
+{
+	uint32_t head = m_head.load(std::memory_order_relaxed);
+	uint32_t tail = m_tail.load(std::memory_order_acquire);
+	size_t space = m_mask + 1 - (head - tail);
+
+	size_t n = len;
+	if(n > space)
+	{
+		m_overflows.store(m_overflows.load(std::memory_order_relaxed) + (len - space), std::memory_order_relaxed);
+		n = space;
+	}
+
+	for(size_t i=0; i<n; i++)
+		m_buf[(head + i) & m_mask] = data[i];
+	m_head.store(head + n, std::memory_order_release);
+	return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Consumer side
+
+/**
+	@brief Gets the oldest contiguous run of queued bytes, without removing them
+
+	@param data		Set to point to the first byte
+
+	@return Number of bytes available at data (may be less than GetPending() if the run wraps around)
+ */
+size_t CLIInputQueue::Peek(const char*& data) const
+{
+	uint32_t tail = m_tail.load(std::memory_order_relaxed);
+	uint32_t head = m_head.load(std::memory_order_acquire);
+
+	uint32_t offset = tail & m_mask;
+	uint32_t len = head - tail;
+	if(len > m_mask + 1 - offset)
+		len = m_mask + 1 - offset;
+
+	data = m_buf + offset;
+	return len;
+}
+
+/**
+	@brief Removes bytes from the queue, after they've been looked at with Peek()
+ */
+void CLIInputQueue::Pop(size_t len)
+{
+	m_tail.store(m_tail.load(std::memory_order_relaxed) + len, std::memory_order_release);
+}
+
+/**
+	@brief Feeds queued keystrokes into a session
+
+	Stops after maxBytes, when the queue is empty, or when the session's output stream is congested, so the time
+	spent in one call is bounded by maxBytes keystrokes (plus any commands they execute).
+
+	@return Number of bytes consumed
+ */
+size_t CLIInputQueue::Pump(CLISessionContextBase& session, size_t maxBytes, bool echo)
+{
+	size_t total = 0;
+	while(total < maxBytes)
+	{
+		const char* data;
+		size_t len = Peek(data);
+		if(len == 0)
+			break;
+		if(len > maxBytes - total)
+			len = maxBytes - total;
+
+		size_t used = session.OnKeystrokes(data, len, echo);
+		Pop(used);
+		total += used;
+
+		//Session is waiting for output to drain
+		if(used < len)
+			break;
+	}
+	return total;
+}
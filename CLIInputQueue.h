@@ -0,0 +1,113 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIInputQueue
+ */
+#ifndef CLIInputQueue_h
+#define CLIInputQueue_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+class CLISessionContextBase;
+
+/**
+	@brief Lock-free single producer, single consumer queue of incoming keystrokes
+
+	Lets a UART RX interrupt or network thread hand off raw bytes without doing any parsing or output itself. The
+	producer calls Push(), and the main loop calls Pump() to feed a bounded number of bytes into a session.
+
+	Only one context may push and only one may pop. Bytes pushed while the queue is full are dropped and counted.
+
+	Capacity must be a power of two.
+ */
+class CLIInputQueue
+{
+public:
+	CLIInputQueue(char* buf, uint32_t size);
+
+	//Producer side
+	bool Push(char c);
+	size_t Push(const char* data, size_t len);
+
+	//Consumer side
+	size_t Peek(const char*& data) const;
+	void Pop(size_t len);
+	size_t Pump(CLISessionContextBase& session, size_t maxBytes, bool echo = true);
+
+	///@brief Returns the number of bytes waiting (exact from the consumer side, a lower bound from the producer)
+	uint32_t GetPending() const
+	{ return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire); }
+
+	///@brief Returns the number of bytes dropped because the queue was full
+	uint32_t GetOverflowCount() const
+	{ return m_overflows.load(std::memory_order_relaxed); }
+
+protected:
+
+	///@brief Queue storage
+	char* m_buf;
+
+	///@brief Capacity minus one, for wrapping indexes
+	uint32_t m_mask;
+
+	///@brief Free-running count of bytes pushed. Only written by the producer.
+	std::atomic<uint32_t> m_head;
+
+	///@brief Free-running count of bytes popped. Only written by the consumer.
+	std::atomic<uint32_t> m_tail;
+
+	///@brief Number of bytes dropped. Only written by the producer.
+	std::atomic<uint32_t> m_overflows;
+};
+
+/**
+	@brief A CLIInputQueue with statically allocated storage
+
+	@tparam SIZE	Capacity in bytes, must be a power of two
+ */
+template<uint32_t SIZE>
+class CLIInputQueueStorage : public CLIInputQueue
+{
+public:
+	static_assert( (SIZE > 0) && ( (SIZE & (SIZE - 1)) == 0), "Queue size must be a power of two");
+
+	CLIInputQueueStorage()
+	: CLIInputQueue(m_storage, SIZE)
+	{}
+
+protected:
+	char m_storage[SIZE];
+};
+
+#endif
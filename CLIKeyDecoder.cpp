@@ -0,0 +1,234 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIKeyDecoder
+ */
+#include "CLIKeyDecoder.h"
+
+///@brief Actions used only inside the decoder, to handle escape sequences
+enum
+{
+	ACTION_ESCAPE = KEY_ACTION_COUNT,	//Start of an escape sequence
+	ACTION_DIGIT,						//Digit of the first numeric parameter
+	ACTION_TILDE						//End of an ESC [ n ~ sequence, which is decoded according to the parameter
+};
+
+static_assert(ACTION_TILDE <= 0x1f, "Actions must fit in the low bits of a transition table entry");
+
+#define K(c) KEYCLASS_##c
+
+/**
+	@brief Character class of each byte
+ */
+const uint8_t CLIKeyDecoder::s_classes[256] =
+{
+	K(CONTROL), K(CTRL_A), K(CTRL_B), K(CONTROL), K(CTRL_D), K(CTRL_E), K(CTRL_F), K(CONTROL),	//0x00
+	K(BACKSPACE), K(TAB), K(NEWLINE), K(CTRL_K), K(CONTROL), K(NEWLINE), K(CTRL_N), K(CONTROL),	//0x08
+	K(CTRL_P), K(CONTROL), K(CONTROL), K(CONTROL), K(CONTROL), K(CTRL_U), K(CONTROL), K(CTRL_W),	//0x10
+	K(CONTROL), K(CONTROL), K(CONTROL), K(ESCAPE), K(CONTROL), K(CONTROL), K(CONTROL), K(CONTROL),	//0x18
+	K(SPACE), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),	//0x20
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),	//0x28
+	K(DIGIT), K(DIGIT), K(DIGIT), K(DIGIT), K(DIGIT), K(DIGIT), K(DIGIT), K(DIGIT),	//0x30
+	K(DIGIT), K(DIGIT), K(OTHER), K(SEMICOLON), K(OTHER), K(OTHER), K(OTHER), K(QUESTION),	//0x38
+	K(OTHER), K(A), K(B), K(C), K(D), K(OTHER), K(F), K(OTHER),	//0x40
+	K(H), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(O),	//0x48
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),	//0x50
+	K(OTHER), K(OTHER), K(OTHER), K(BRACKET), K(OTHER), K(OTHER), K(OTHER), K(OTHER),	//0x58
+	K(OTHER), K(OTHER), K(LOWER_B), K(OTHER), K(OTHER), K(OTHER), K(LOWER_F), K(OTHER),	//0x60
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),	//0x68
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),	//0x70
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(TILDE), K(BACKSPACE),	//0x78
+
+	//0x80 - 0xff
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER),
+	K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER), K(OTHER)
+};
+
+#undef K
+
+#define T(state, action) static_cast<uint8_t>( (KEYSTATE_##state << KEY_STATE_SHIFT) | (action) )
+
+/**
+	@brief Keys which do the same thing in every state, and end any escape sequence in progress
+
+	Starting with KEYCLASS_SPACE.
+ */
+#define CONTROL_KEYS \
+	T(NORMAL, KEY_SPACE), T(NORMAL, KEY_HELP), T(NORMAL, KEY_ENTER), T(NORMAL, KEY_TAB), \
+	T(NORMAL, KEY_BACKSPACE), T(ESCAPE, ACTION_ESCAPE), \
+	T(NORMAL, KEY_HOME), T(NORMAL, KEY_LEFT), T(NORMAL, KEY_DELETE), T(NORMAL, KEY_END), \
+	T(NORMAL, KEY_RIGHT), T(NORMAL, KEY_KILL_TO_END), T(NORMAL, KEY_DOWN), T(NORMAL, KEY_UP), \
+	T(NORMAL, KEY_KILL_TO_START), T(NORMAL, KEY_KILL_WORD), T(NORMAL, KEY_NONE)
+
+/**
+	@brief Next state and action, indexed by current state and character class
+
+	Column order is that of the character classes:
+		OTHER, DIGIT, SEMICOLON, BRACKET, O,
+		A, B, C, D, H, F, TILDE, LOWER_B, LOWER_F,
+		then CONTROL_KEYS
+ */
+const uint8_t CLIKeyDecoder::s_transitions[KEYSTATE_COUNT][KEYCLASS_COUNT] =
+{
+	//KEYSTATE_NORMAL
+	{
+		T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT),
+		T(NORMAL, KEY_INSERT),
+		T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT),
+		T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT), T(NORMAL, KEY_INSERT),
+		T(NORMAL, KEY_INSERT),
+		CONTROL_KEYS
+	},
+
+	//KEYSTATE_ESCAPE: Alt-b and Alt-f move by words, anything other than [ or O is an unknown Alt key
+	{
+		T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(CSI, KEY_NONE),
+		T(SS3, KEY_NONE),
+		T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(NORMAL, KEY_WORD_LEFT),
+		T(NORMAL, KEY_WORD_RIGHT),
+		CONTROL_KEYS
+	},
+
+	//KEYSTATE_CSI
+	{
+		T(NORMAL, KEY_NONE), T(PARAM, ACTION_DIGIT), T(MODIFIER, KEY_NONE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_UP), T(NORMAL, KEY_DOWN), T(NORMAL, KEY_RIGHT), T(NORMAL, KEY_LEFT),
+		T(NORMAL, KEY_HOME), T(NORMAL, KEY_END), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		CONTROL_KEYS
+	},
+
+	//KEYSTATE_PARAM
+	{
+		T(NORMAL, KEY_NONE), T(PARAM, ACTION_DIGIT), T(MODIFIER, KEY_NONE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_UP), T(NORMAL, KEY_DOWN), T(NORMAL, KEY_RIGHT), T(NORMAL, KEY_LEFT),
+		T(NORMAL, KEY_HOME), T(NORMAL, KEY_END), T(NORMAL, ACTION_TILDE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		CONTROL_KEYS
+	},
+
+	//KEYSTATE_MODIFIER: modified left and right arrows move by words, other keys ignore the modifier
+	{
+		T(NORMAL, KEY_NONE), T(MODIFIER, KEY_NONE), T(MODIFIER, KEY_NONE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_UP), T(NORMAL, KEY_DOWN), T(NORMAL, KEY_WORD_RIGHT), T(NORMAL, KEY_WORD_LEFT),
+		T(NORMAL, KEY_HOME), T(NORMAL, KEY_END), T(NORMAL, ACTION_TILDE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		CONTROL_KEYS
+	},
+
+	//KEYSTATE_SS3
+	{
+		T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_UP), T(NORMAL, KEY_DOWN), T(NORMAL, KEY_RIGHT), T(NORMAL, KEY_LEFT),
+		T(NORMAL, KEY_HOME), T(NORMAL, KEY_END), T(NORMAL, KEY_NONE), T(NORMAL, KEY_NONE),
+		T(NORMAL, KEY_NONE),
+		CONTROL_KEYS
+	}
+};
+
+#undef CONTROL_KEYS
+#undef T
+
+/**
+	@brief Returns true if a character is inserted into the line as-is, rather than being an editing key
+ */
+bool CLIKeyDecoder::IsOrdinary(char c)
+{
+	return s_transitions[KEYSTATE_NORMAL][s_classes[static_cast<uint8_t>(c)]] == KEY_INSERT;
+}
+
+/**
+	@brief Handles the actions which are internal to escape sequence decoding
+
+	@return The key decoded, if the sequence is complete
+ */
+clikeyaction_t CLIKeyDecoder::OnSequenceAction(uint8_t action, char c)
+{
+	switch(action)
+	{
+		case ACTION_ESCAPE:
+			m_param = 0;
+			return KEY_NONE;
+
+		case ACTION_DIGIT:
+			if(m_param < 1000)
+				m_param = m_param*10 + (c - '0');
+			return KEY_NONE;
+
+		//ESC [ n ~ (the editing keypad, and bracketed paste)
+		case ACTION_TILDE:
+			switch(m_param)
+			{
+				case 1:
+				case 7:
+					return KEY_HOME;
+
+				case 3:
+					return KEY_DELETE;
+
+				case 4:
+				case 8:
+					return KEY_END;
+
+				case 200:
+					return KEY_PASTE_START;
+
+				case 201:
+					return KEY_PASTE_END;
+
+				default:
+					return KEY_NONE;
+			}
+
+		default:
+			return KEY_NONE;
+	}
+}
@@ -0,0 +1,197 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIKeyDecoder
+ */
+#ifndef CLIKeyDecoder_h
+#define CLIKeyDecoder_h
+
+#include <stdint.h>
+
+///@brief Editor actions decoded from keystrokes
+enum clikeyaction_t
+{
+	KEY_NONE,			//Nothing to do (partial escape sequence, or an unbound key)
+	KEY_INSERT,			//Ordinary character, inserted into the line as-is
+	KEY_SPACE,
+	KEY_ENTER,
+	KEY_TAB,
+	KEY_HELP,
+	KEY_BACKSPACE,
+	KEY_DELETE,			//Delete the character right of the cursor
+	KEY_LEFT,
+	KEY_RIGHT,
+	KEY_UP,
+	KEY_DOWN,
+	KEY_HOME,
+	KEY_END,
+	KEY_WORD_LEFT,
+	KEY_WORD_RIGHT,
+	KEY_KILL_TO_END,
+	KEY_KILL_TO_START,
+	KEY_KILL_WORD,		//Delete the word left of the cursor
+	KEY_PASTE_START,
+	KEY_PASTE_END,
+
+	KEY_ACTION_COUNT
+};
+
+/**
+	@brief Decodes keystrokes, including VT100 / ANSI / xterm escape sequences, into editor actions
+
+	Decoding is a DFA driven by two const tables (which live in flash): one maps each byte to a character class, and
+	the other maps the current state and character class to the next state and the action to take. Each byte costs
+	one lookup in each, and ordinary characters take no other branches.
+
+	Recognized keys:
+		* Arrows (ESC [ A through D, and ESC O A through D)
+		* Ctrl-arrows and other modified arrows (ESC [ 1 ; 5 D etc), and Alt-b / Alt-f, for moving by words
+		* Home and End (ESC [ H / F, ESC O H / F, ESC [ 1 ~ / 4 ~, ESC [ 7 ~ / 8 ~) and Ctrl-A / Ctrl-E
+		* Delete (ESC [ 3 ~) and Ctrl-D
+		* Ctrl-B / Ctrl-F / Ctrl-P / Ctrl-N, as left / right / up / down
+		* Ctrl-K, Ctrl-U and Ctrl-W, to delete to the end of the line, to the start, and the word left of the cursor
+		* Start and end of bracketed paste (ESC [ 200 ~ and ESC [ 201 ~)
+
+	Other control characters, and unrecognized escape sequences, are dropped.
+ */
+class CLIKeyDecoder
+{
+public:
+	CLIKeyDecoder()
+	{ Reset(); }
+
+	///@brief Abandons any partial escape sequence
+	void Reset()
+	{
+		m_state = KEYSTATE_NORMAL;
+		m_param = 0;
+	}
+
+	///@brief Returns true if not partway through an escape sequence
+	bool IsIdle() const
+	{ return m_state == KEYSTATE_NORMAL; }
+
+	/**
+		@brief Decodes the next byte of input
+
+		@return The action to take, if the byte completes a key
+	 */
+	clikeyaction_t Decode(char c)
+	{
+		uint8_t entry = s_transitions[m_state][s_classes[static_cast<uint8_t>(c)]];
+		m_state = entry >> KEY_STATE_SHIFT;
+
+		uint8_t action = entry & KEY_ACTION_MASK;
+		if(action < KEY_ACTION_COUNT)
+			return static_cast<clikeyaction_t>(action);
+		return OnSequenceAction(action, c);
+	}
+
+	/**
+		@brief Handles an escape character received outside the decoder (for instance, by a pager)
+
+		The rest of the sequence is decoded as usual, rather than being typed into the line.
+	 */
+	void OnEscape()
+	{ Decode('\x1b'); }
+
+	static bool IsOrdinary(char c);
+
+protected:
+	clikeyaction_t OnSequenceAction(uint8_t action, char c);
+
+	///@brief Decoder states
+	enum
+	{
+		KEYSTATE_NORMAL,	//Not in an escape sequence
+		KEYSTATE_ESCAPE,	//After ESC
+		KEYSTATE_CSI,		//After ESC [
+		KEYSTATE_PARAM,		//In the first numeric parameter of a CSI sequence
+		KEYSTATE_MODIFIER,	//After the ';' of a CSI sequence
+		KEYSTATE_SS3,		//After ESC O
+
+		KEYSTATE_COUNT
+	};
+
+	///@brief Character classes (bytes which all have the same effect in every state)
+	enum
+	{
+		KEYCLASS_OTHER,		//Printable characters not listed below, and all bytes with the high bit set
+		KEYCLASS_DIGIT,
+		KEYCLASS_SEMICOLON,
+		KEYCLASS_BRACKET,
+		KEYCLASS_O,
+		KEYCLASS_A,
+		KEYCLASS_B,
+		KEYCLASS_C,
+		KEYCLASS_D,
+		KEYCLASS_H,
+		KEYCLASS_F,
+		KEYCLASS_TILDE,
+		KEYCLASS_LOWER_B,
+		KEYCLASS_LOWER_F,
+		KEYCLASS_SPACE,
+		KEYCLASS_QUESTION,
+		KEYCLASS_NEWLINE,
+		KEYCLASS_TAB,
+		KEYCLASS_BACKSPACE,
+		KEYCLASS_ESCAPE,
+		KEYCLASS_CTRL_A,
+		KEYCLASS_CTRL_B,
+		KEYCLASS_CTRL_D,
+		KEYCLASS_CTRL_E,
+		KEYCLASS_CTRL_F,
+		KEYCLASS_CTRL_K,
+		KEYCLASS_CTRL_N,
+		KEYCLASS_CTRL_P,
+		KEYCLASS_CTRL_U,
+		KEYCLASS_CTRL_W,
+		KEYCLASS_CONTROL,	//Other control characters
+
+		KEYCLASS_COUNT
+	};
+
+	///@brief Each transition table entry holds the next state in the high bits and the action in the low bits
+	static const uint8_t KEY_STATE_SHIFT = 5;
+	static const uint8_t KEY_ACTION_MASK = (1 << KEY_STATE_SHIFT) - 1;
+
+	static const uint8_t s_classes[256];
+	static const uint8_t s_transitions[KEYSTATE_COUNT][KEYCLASS_COUNT];
+
+	///@brief Current state
+	uint8_t m_state;
+
+	///@brief First numeric parameter of the CSI sequence being decoded
+	uint16_t m_param;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of clikeyword_t
+ */
+#ifndef CLIKeyword_h
+#define CLIKeyword_h
+
+#include <stdint.h>
+
+/**
+	@brief A single keyword in the CLI command tree
+
+	Each level of the tree is an array of keywords terminated by an entry with a null keyword.
+ */
+struct clikeyword_t
+{
+	///@brief ASCII representation of the unabbreviated keyword
+	const char*			keyword;
+
+	///@brief Integer identifier used by the command parser
+	uint16_t			id;
+
+	///@brief Child nodes for subsequent words
+	const clikeyword_t*	children;
+
+	///@brief Help message
+	const char*			help;
+
+	/**
+		@brief Index of the handler for commands ending at or below this keyword, or zero for none
+
+		See CLISessionContext::SetHandlers(). May be left out of initializers, in which case it's zero.
+	 */
+	uint16_t			handler = 0;
+};
+
+/**
+	@brief Result of matching a single token against one level of the command tree
+ */
+enum clikeywordmatch_t
+{
+	///@brief The token does not match anything legal at this level
+	MATCH_NONE,
+
+	///@brief The token is a keyword, or an unambiguous abbreviation of one
+	MATCH_KEYWORD,
+
+	///@brief The token is an abbreviation of more than one keyword
+	MATCH_AMBIGUOUS,
+
+	///@brief The token matches no keyword, but the level accepts a freeform or text argument
+	MATCH_WILDCARD
+};
+
+#endif
@@ -0,0 +1,551 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIKeywordIndex
+ */
+#include "CLIKeywordIndex.h"
+#include "CLIToken.h"
+#include <stddef.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Construction
+
+CLIKeywordIndex::CLIKeywordIndex(
+	cliindexlevel_t* levels,
+	uint16_t maxLevels,
+	cliindexrow_t* rows,
+	uint16_t maxRows,
+	clitrienode_t* nodes,
+	uint16_t maxNodes)
+	: m_root(NULL)
+	, m_levels(levels)
+	, m_rows(rows)
+	, m_nodes(nodes)
+	, m_levelCount(0)
+	, m_maxLevels(maxLevels)
+	, m_rowCount(0)
+	, m_maxRows(maxRows)
+	, m_nodeCount(0)
+	, m_maxNodes(maxNodes)
+{
+}
+
+/**
+	@brief Builds the index for a command tree
+
+	Arrays of keywords shared by more than one parent (or reached recursively) are indexed only once.
+
+	@return True on success, false if the tree is empty or doesn't fit in the available storage
+ */
+bool CLIKeywordIndex::Build(const clikeyword_t* root)
+{
+	m_root = NULL;
+	m_levelCount = 0;
+	m_rowCount = 0;
+	m_nodeCount = 0;
+
+	if(root == NULL)
+		return false;
+
+	//Levels are added to the end of the table as they're discovered, so this is a breadth-first walk of the tree
+	FindOrAddLevel(root);
+	for(uint16_t i=0; i<m_levelCount; i++)
+	{
+		if(!BuildLevel(i))
+			return false;
+	}
+
+	m_root = root;
+	return true;
+}
+
+/**
+	@brief Gets the level number for a keyword array, adding a new level if we haven't seen it before
+ */
+uint16_t CLIKeywordIndex::FindOrAddLevel(const clikeyword_t* rows)
+{
+	for(uint16_t i=0; i<m_levelCount; i++)
+	{
+		if(m_levels[i].rows == rows)
+			return i;
+	}
+
+	if(m_levelCount >= m_maxLevels)
+		return CLI_INDEX_NONE;
+
+	auto& level = m_levels[m_levelCount];
+	level.rows = rows;
+	level.firstRow = CLI_INDEX_NONE;
+	level.trie = CLI_INDEX_NONE;
+	level.wildcard = CLI_INDEX_NONE;
+	level.hashSize = 0;
+	level.helpWidth = 0;
+	return m_levelCount ++;
+}
+
+/**
+	@brief Adds all of the keywords in a level to the trie
+ */
+bool CLIKeywordIndex::BuildLevel(uint16_t level)
+{
+	const clikeyword_t* rows = m_levels[level].rows;
+
+	uint16_t nrows = 0;
+	while(rows[nrows].keyword != NULL)
+		nrows ++;
+
+	if( (m_rowCount + nrows) > m_maxRows)
+		return false;
+	m_levels[level].firstRow = m_rowCount;
+	m_rowCount += nrows;
+
+	for(uint16_t i=0; i<nrows; i++)
+	{
+		//Record where this row's children live
+		uint16_t child = CLI_INDEX_NONE;
+		if(rows[i].children != NULL)
+		{
+			child = FindOrAddLevel(rows[i].children);
+			if(child == CLI_INDEX_NONE)
+				return false;
+		}
+		auto& info = m_rows[m_levels[level].firstRow + i];
+		info.child = child;
+		info.collision = CLI_INDEX_NONE;
+		info.uniqueLen = 0;
+
+		size_t len = strlen(rows[i].keyword);
+		if(len > 255)
+			len = 255;
+		if(len > m_levels[level].helpWidth)
+			m_levels[level].helpWidth = len;
+
+		//Freeform and text arguments don't go in the trie, they're only used if no keyword matches
+		if( (rows[i].id == FREEFORM_TOKEN) || (rows[i].id == TEXT_TOKEN) )
+		{
+			if(m_levels[level].wildcard == CLI_INDEX_NONE)
+				m_levels[level].wildcard = i;
+		}
+
+		else
+		{
+			if(!AddKeyword(level, i))
+				return false;
+			FindUniquePrefix(level, i, nrows);
+		}
+	}
+
+	BuildHash(level, nrows);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Perfect hashing
+
+///@brief Largest number of keywords in one bucket of a perfect hash table
+#define MAX_HASH_BUCKET 8
+
+///@brief Largest displacement tried when placing a bucket (the high bit of hashSeed is used while building)
+#define MAX_HASH_SEED 0x7f
+
+///@brief Marks a hashSeed which is still holding a bucket size, during BuildHash()
+#define HASH_SEED_PENDING 0x80
+
+///@brief Returns true if a keyword is a freeform or text argument, rather than an actual keyword
+static bool IsWildcard(const clikeyword_t& keyword)
+{
+	return (keyword.id == FREEFORM_TOKEN) || (keyword.id == TEXT_TOKEN);
+}
+
+///@brief Hashes a token (32-bit FNV-1a)
+static uint32_t KeywordHash(const char* text, uint16_t len)
+{
+	uint32_t hash = 0x811c9dc5;
+	for(uint16_t i=0; i<len; i++)
+	{
+		hash ^= static_cast<uint8_t>(text[i]);
+		hash *= 0x01000193;
+	}
+	return hash;
+}
+
+///@brief Finds the slot for a hash within its bucket's displacement
+static uint16_t HashSlot(uint32_t hash, uint8_t seed, uint16_t size)
+{
+	uint32_t x = hash + seed * 0x9e3779b9;
+	x ^= x >> 16;
+	x *= 0x85ebca6b;
+	x ^= x >> 13;
+	return x % size;
+}
+
+/**
+	@brief Builds a minimal perfect hash of the keywords at a level (hash and displace)
+
+	Keywords are split into buckets by hash, then each bucket gets the smallest displacement which puts all of its
+	keywords in empty slots. Biggest buckets are placed first since they're the hardest to fit.
+
+	If no table can be found the level is left without one, and every lookup walks the trie.
+ */
+void CLIKeywordIndex::BuildHash(uint16_t level, uint16_t nrows)
+{
+	auto& lev = m_levels[level];
+	const clikeyword_t* rows = lev.rows;
+	cliindexrow_t* info = m_rows + lev.firstRow;
+	lev.hashSize = 0;
+
+	uint16_t n = 0;
+	for(uint16_t i=0; i<nrows; i++)
+	{
+		if(!IsWildcard(rows[i]))
+			n ++;
+	}
+	if(n == 0)
+		return;
+
+	//Count the keywords in each bucket, keeping the counts in the seeds for now
+	for(uint16_t i=0; i<n; i++)
+	{
+		info[i].hashSeed = HASH_SEED_PENDING;
+		info[i].hashSlot = CLI_INDEX_NONE;
+	}
+	for(uint16_t i=0; i<nrows; i++)
+	{
+		if(IsWildcard(rows[i]))
+			continue;
+
+		auto& bucket = info[KeywordHash(rows[i].keyword, strlen(rows[i].keyword)) % n];
+		if(bucket.hashSeed == (HASH_SEED_PENDING | MAX_HASH_BUCKET) )
+			return;
+		bucket.hashSeed ++;
+	}
+
+	for(uint8_t size = MAX_HASH_BUCKET; size > 0; size--)
+	{
+		for(uint16_t b=0; b<n; b++)
+		{
+			if(info[b].hashSeed != (HASH_SEED_PENDING | size) )
+				continue;
+
+			//Find the keywords in this bucket. If a keyword appears twice, only the first one can ever match.
+			uint16_t keys[MAX_HASH_BUCKET];
+			uint32_t hashes[MAX_HASH_BUCKET];
+			uint16_t count = 0;
+			for(uint16_t i=0; i<nrows; i++)
+			{
+				if(IsWildcard(rows[i]))
+					continue;
+				uint32_t hash = KeywordHash(rows[i].keyword, strlen(rows[i].keyword));
+				if( (hash % n) != b)
+					continue;
+
+				bool duplicate = false;
+				for(uint16_t j=0; j<count; j++)
+				{
+					if(strcmp(rows[keys[j]].keyword, rows[i].keyword) == 0)
+						duplicate = true;
+				}
+				if(duplicate)
+					continue;
+
+				keys[count] = i;
+				hashes[count] = hash;
+				count ++;
+			}
+
+			//Find a displacement which puts every keyword in an empty slot
+			bool placed = false;
+			for(uint8_t seed = 0; (seed <= MAX_HASH_SEED) && !placed; seed++)
+			{
+				uint16_t slots[MAX_HASH_BUCKET];
+				placed = true;
+				for(uint16_t j=0; (j<count) && placed; j++)
+				{
+					slots[j] = HashSlot(hashes[j], seed, n);
+					if(info[slots[j]].hashSlot != CLI_INDEX_NONE)
+						placed = false;
+					for(uint16_t k=0; k<j; k++)
+					{
+						if(slots[k] == slots[j])
+							placed = false;
+					}
+				}
+
+				if(placed)
+				{
+					for(uint16_t j=0; j<count; j++)
+						info[slots[j]].hashSlot = keys[j];
+					info[b].hashSeed = seed;
+				}
+			}
+
+			//Give up, the trie will still work
+			if(!placed)
+				return;
+		}
+	}
+
+	//Empty buckets don't need a seed
+	for(uint16_t i=0; i<n; i++)
+	{
+		if(info[i].hashSeed == HASH_SEED_PENDING)
+			info[i].hashSeed = 0;
+	}
+	lev.hashSize = n;
+}
+
+/**
+	@brief Fills out the shortest-unique-prefix table entry for a keyword
+
+	This is quadratic in the number of keywords at the level, but only runs once.
+ */
+void CLIKeywordIndex::FindUniquePrefix(uint16_t level, uint16_t row, uint16_t nrows)
+{
+	const clikeyword_t* rows = m_levels[level].rows;
+	const char* keyword = rows[row].keyword;
+
+	uint16_t longest = 0;
+	uint16_t collision = CLI_INDEX_NONE;
+	for(uint16_t i=0; i<nrows; i++)
+	{
+		if( (i == row) || (rows[i].id == FREEFORM_TOKEN) || (rows[i].id == TEXT_TOKEN) )
+			continue;
+
+		//Find the length of the common prefix
+		const char* other = rows[i].keyword;
+		uint16_t len = 0;
+		while( (keyword[len] != '\0') && (keyword[len] == other[len]) )
+			len ++;
+
+		if( (collision == CLI_INDEX_NONE) || (len > longest) )
+		{
+			longest = len;
+			collision = i;
+		}
+	}
+
+	//Anything longer than the longest prefix shared with another keyword is unique
+	auto& info = m_rows[m_levels[level].firstRow + row];
+	info.collision = collision;
+	if(longest >= 0xff)
+		info.uniqueLen = 0xff;
+	else
+		info.uniqueLen = longest + 1;
+}
+
+/**
+	@brief Inserts a single keyword into the trie for its level
+ */
+bool CLIKeywordIndex::AddKeyword(uint16_t level, uint16_t row)
+{
+	const char* keyword = m_levels[level].rows[row].keyword;
+
+	//Empty keywords can never be typed, don't bother indexing them
+	if(*keyword == '\0')
+		return true;
+
+	uint16_t* link = &m_levels[level].trie;
+	uint16_t node = CLI_INDEX_NONE;
+	for(const char* p = keyword; *p != '\0'; p++)
+	{
+		//Look for an existing node for this character
+		node = *link;
+		while( (node != CLI_INDEX_NONE) && (m_nodes[node].ch != *p) )
+		{
+			link = &m_nodes[node].sibling;
+			node = *link;
+		}
+
+		//Not found, append a new one to the end of the sibling list
+		if(node == CLI_INDEX_NONE)
+		{
+			if(m_nodeCount >= m_maxNodes)
+				return false;
+
+			node = m_nodeCount ++;
+			m_nodes[node].child = CLI_INDEX_NONE;
+			m_nodes[node].sibling = CLI_INDEX_NONE;
+			m_nodes[node].row = CLI_INDEX_NONE;
+			m_nodes[node].firstRow = row;
+			m_nodes[node].ch = *p;
+			*link = node;
+		}
+
+		link = &m_nodes[node].child;
+	}
+
+	//If the same keyword appears twice, the first one wins (same as a linear search)
+	if(m_nodes[node].row == CLI_INDEX_NONE)
+		m_nodes[node].row = row;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Lookup
+
+/**
+	@brief Matches a token against the keywords at one level of the tree
+
+	@param level	The level to search
+	@param text		The token to match (need not be null terminated)
+	@param len		Length of the token
+	@param row		The matching row. For ambiguous matches, one of the candidate keywords.
+	@param other	For ambiguous matches, a second candidate keyword
+ */
+clikeywordmatch_t CLIKeywordIndex::Match(uint16_t level, const char* text, uint16_t len, uint16_t& row, uint16_t& other) const
+{
+	auto& lev = m_levels[level];
+
+	//Most tokens are typed in full, and can be found with a single hash lookup
+	if(lev.hashSize != 0)
+	{
+		uint32_t hash = KeywordHash(text, len);
+		uint8_t seed = m_rows[lev.firstRow + (hash % lev.hashSize)].hashSeed;
+		uint16_t slot = m_rows[lev.firstRow + HashSlot(hash, seed, lev.hashSize)].hashSlot;
+		if( (slot != CLI_INDEX_NONE) &&
+			(strncmp(lev.rows[slot].keyword, text, len) == 0) &&
+			(lev.rows[slot].keyword[len] == '\0') )
+		{
+			row = slot;
+			return MATCH_KEYWORD;
+		}
+	}
+
+	//Walk down the trie one character at a time
+	uint16_t next = lev.trie;
+	uint16_t node = CLI_INDEX_NONE;
+	for(uint16_t i = 0; i < len; i++)
+	{
+		while( (next != CLI_INDEX_NONE) && (m_nodes[next].ch != text[i]) )
+			next = m_nodes[next].sibling;
+
+		//Fell off the trie, so no keyword matches
+		if(next == CLI_INDEX_NONE)
+		{
+			node = CLI_INDEX_NONE;
+			break;
+		}
+
+		node = next;
+		next = m_nodes[node].child;
+	}
+
+	//Not a prefix of any keyword. Use the wildcard if we have one
+	if(node == CLI_INDEX_NONE)
+	{
+		if(lev.wildcard == CLI_INDEX_NONE)
+			return MATCH_NONE;
+
+		row = lev.wildcard;
+		return MATCH_WILDCARD;
+	}
+
+	//Exact matches win, even if the token is also a prefix of something else
+	if(m_nodes[node].row != CLI_INDEX_NONE)
+	{
+		row = m_nodes[node].row;
+		return MATCH_KEYWORD;
+	}
+
+	//The token is a prefix of this keyword. It's ambiguous if it's shorter than the keyword's shortest unique prefix,
+	//in which case the keyword we collide with must also start with the token.
+	row = m_nodes[node].firstRow;
+	auto& info = m_rows[lev.firstRow + row];
+	if(len >= info.uniqueLen)
+		return MATCH_KEYWORD;
+
+	other = info.collision;
+	return MATCH_AMBIGUOUS;
+}
+
+/**
+	@brief Finds how far a partially typed keyword can be completed
+
+	@param level		The level to search
+	@param text			The token typed so far (need not be null terminated)
+	@param len			Length of the token, must be nonzero
+	@param row			On success, a keyword which starts with the completion
+	@param commonLen	On success, length of the prefix shared by every keyword starting with the token
+
+	@return	MATCH_KEYWORD if only one keyword can be meant (or the token is already a complete keyword),
+			MATCH_AMBIGUOUS if there's more than one, or MATCH_NONE if no keyword starts with the token
+ */
+clikeywordmatch_t CLIKeywordIndex::Complete(
+	uint16_t level,
+	const char* text,
+	uint16_t len,
+	uint16_t& row,
+	uint16_t& commonLen) const
+{
+	//Find the node for the token, same as Match()
+	uint16_t next = m_levels[level].trie;
+	uint16_t node = CLI_INDEX_NONE;
+	for(uint16_t i = 0; i < len; i++)
+	{
+		while( (next != CLI_INDEX_NONE) && (m_nodes[next].ch != text[i]) )
+			next = m_nodes[next].sibling;
+		if(next == CLI_INDEX_NONE)
+			return MATCH_NONE;
+
+		node = next;
+		next = m_nodes[node].child;
+	}
+	if(node == CLI_INDEX_NONE)
+		return MATCH_NONE;
+
+	//Exact matches are already complete, even if they're also a prefix of something else
+	commonLen = len;
+	if(m_nodes[node].row != CLI_INDEX_NONE)
+	{
+		row = m_nodes[node].row;
+		return MATCH_KEYWORD;
+	}
+
+	//Follow the trie as long as there's only one way to go, stopping at the end of any keyword.
+	//Nodes which don't end a keyword always have at least one child.
+	while(m_nodes[node].row == CLI_INDEX_NONE)
+	{
+		uint16_t child = m_nodes[node].child;
+		if(m_nodes[child].sibling != CLI_INDEX_NONE)
+			break;
+
+		node = child;
+		commonLen ++;
+	}
+
+	row = m_nodes[node].firstRow;
+	if( (m_nodes[node].row != CLI_INDEX_NONE) && (m_nodes[node].child == CLI_INDEX_NONE) )
+		return MATCH_KEYWORD;
+	return MATCH_AMBIGUOUS;
+}
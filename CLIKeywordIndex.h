@@ -0,0 +1,237 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIKeywordIndex
+ */
+#ifndef CLIKeywordIndex_h
+#define CLIKeywordIndex_h
+
+#include "CLIKeyword.h"
+
+///@brief Null entry in keyword index tables
+#define CLI_INDEX_NONE 0xffff
+
+/**
+	@brief A single character in the keyword prefix trie
+
+	Children of a node are stored as a singly linked list of siblings.
+ */
+struct clitrienode_t
+{
+	///@brief Index of the first child node, or CLI_INDEX_NONE
+	uint16_t	child;
+
+	///@brief Index of the next sibling node, or CLI_INDEX_NONE
+	uint16_t	sibling;
+
+	///@brief Row of the keyword ending at this node, or CLI_INDEX_NONE
+	uint16_t	row;
+
+	///@brief Lowest numbered row of any keyword at or below this node
+	uint16_t	firstRow;
+
+	///@brief The character this node matches
+	char		ch;
+};
+
+/**
+	@brief Index entry for a single keyword
+
+	uniqueLen and collision together form a shortest-unique-prefix table for each level. Once the trie has located any
+	keyword starting with the token, checking the token length against that keyword's uniqueLen is enough to tell
+	whether the abbreviation is ambiguous. This doesn't depend on the order of keywords in the table.
+ */
+struct cliindexrow_t
+{
+	///@brief Level reached by following this row's children, or CLI_INDEX_NONE
+	uint16_t	child;
+
+	///@brief Another keyword at the same level sharing the longest common prefix with this one, or CLI_INDEX_NONE
+	uint16_t	collision;
+
+	/**
+		@brief Length of the shortest abbreviation that identifies this keyword unambiguously
+
+		If the keyword is itself a prefix of another keyword, this is one more than its length (i.e. it can only be
+		matched exactly).
+	 */
+	uint8_t		uniqueLen;
+
+	/**
+		@brief Displacement for the perfect hash bucket with this row's number
+
+		(The hash tables have one bucket and one slot per keyword, so they're stored alongside the rows.)
+	 */
+	uint8_t		hashSeed;
+
+	///@brief Row of the keyword in the perfect hash slot with this row's number, or CLI_INDEX_NONE
+	uint16_t	hashSlot;
+};
+
+/**
+	@brief Index entry for a single level (keyword array) of the command tree
+ */
+struct cliindexlevel_t
+{
+	///@brief The keywords at this level
+	const clikeyword_t*	rows;
+
+	///@brief Position of this level's first row in the per-row table
+	uint16_t			firstRow;
+
+	///@brief First top level trie node for this level, or CLI_INDEX_NONE if there are no keywords
+	uint16_t			trie;
+
+	///@brief Row of the freeform or text argument at this level, or CLI_INDEX_NONE if there is none
+	uint16_t			wildcard;
+
+	///@brief Number of slots in this level's perfect hash table, or zero if it doesn't have one
+	uint16_t			hashSize;
+
+	///@brief Length of the longest keyword at this level, for laying out help (capped at 255)
+	uint8_t				helpWidth;
+};
+
+/**
+	@brief Precomputed prefix trie over a clikeyword_t command tree
+
+	Matching a token against a level of the tree takes time proportional to the length of the token, rather than the
+	number of keywords at that level. Each level also gets a minimal perfect hash of its keywords, so fully typed
+	keywords (the common case for scripts) are found with one hash and one string compare, and only abbreviations
+	need to walk the trie.
+
+	The index is built once (typically at startup) into caller supplied storage and never allocates. It is read-only
+	after Build() returns, so a single index may be shared by any number of CLISessionContext's using the same tree.
+
+	Levels are numbered in the order they're first reached, with the root of the tree always being level 0.
+ */
+class CLIKeywordIndex
+{
+public:
+	CLIKeywordIndex(
+		cliindexlevel_t* levels,
+		uint16_t maxLevels,
+		cliindexrow_t* rows,
+		uint16_t maxRows,
+		clitrienode_t* nodes,
+		uint16_t maxNodes);
+
+	bool Build(const clikeyword_t* root);
+
+	/**
+		@brief Returns the root of the tree this index was built from, or NULL if it hasn't been built
+	 */
+	const clikeyword_t* GetRoot() const
+	{ return m_root; }
+
+	/**
+		@brief Returns the keyword array for a level
+	 */
+	const clikeyword_t* GetRows(uint16_t level) const
+	{ return m_levels[level].rows; }
+
+	/**
+		@brief Returns the level reached by following a row's children, or CLI_INDEX_NONE if it has none
+	 */
+	uint16_t GetChildLevel(uint16_t level, uint16_t row) const
+	{ return m_rows[m_levels[level].firstRow + row].child; }
+
+	/**
+		@brief Returns the length of the longest keyword at a level, for laying out help
+	 */
+	uint8_t GetHelpWidth(uint16_t level) const
+	{ return m_levels[level].helpWidth; }
+
+	clikeywordmatch_t Match(uint16_t level, const char* text, uint16_t len, uint16_t& row, uint16_t& other) const;
+	clikeywordmatch_t Complete(uint16_t level, const char* text, uint16_t len, uint16_t& row, uint16_t& commonLen) const;
+
+	///@brief Number of levels used by the index (for sizing storage)
+	uint16_t GetLevelCount() const
+	{ return m_levelCount; }
+
+	///@brief Number of rows used by the index (for sizing storage)
+	uint16_t GetRowCount() const
+	{ return m_rowCount; }
+
+	///@brief Number of trie nodes used by the index (for sizing storage)
+	uint16_t GetNodeCount() const
+	{ return m_nodeCount; }
+
+protected:
+	uint16_t FindOrAddLevel(const clikeyword_t* rows);
+	bool BuildLevel(uint16_t level);
+	bool AddKeyword(uint16_t level, uint16_t row);
+	void FindUniquePrefix(uint16_t level, uint16_t row, uint16_t nrows);
+	void BuildHash(uint16_t level, uint16_t nrows);
+
+	///@brief Root of the tree, or NULL if not yet built
+	const clikeyword_t* m_root;
+
+	///@brief Per-level data
+	cliindexlevel_t* m_levels;
+
+	///@brief Per-row data, indexed by level firstRow plus row number
+	cliindexrow_t* m_rows;
+
+	///@brief Trie nodes for all levels
+	clitrienode_t* m_nodes;
+
+	uint16_t m_levelCount;
+	uint16_t m_maxLevels;
+	uint16_t m_rowCount;
+	uint16_t m_maxRows;
+	uint16_t m_nodeCount;
+	uint16_t m_maxNodes;
+};
+
+/**
+	@brief A CLIKeywordIndex with statically allocated storage
+
+	@tparam LEVELS	Number of distinct keyword arrays in the tree
+	@tparam ROWS	Total number of rows (not counting terminators) across all distinct keyword arrays
+	@tparam NODES	Trie nodes. Never more than the total number of characters in all keywords.
+ */
+template<uint16_t LEVELS, uint16_t ROWS, uint16_t NODES>
+class CLIKeywordIndexStorage : public CLIKeywordIndex
+{
+public:
+	CLIKeywordIndexStorage()
+	: CLIKeywordIndex(m_levelStorage, LEVELS, m_rowStorage, ROWS, m_nodeStorage, NODES)
+	{}
+
+protected:
+	cliindexlevel_t	m_levelStorage[LEVELS];
+	cliindexrow_t	m_rowStorage[ROWS];
+	clitrienode_t	m_nodeStorage[NODES];
+};
+
+#endif
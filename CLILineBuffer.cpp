@@ -0,0 +1,98 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLILineBuffer
+ */
+#include "CLILineBuffer.h"
+#include <string.h>
+
+/**
+	@brief Inserts a block of characters at the cursor
+
+	@return Number of characters inserted, which may be less than len if the line is full
+ */
+size_t CLILineBuffer::Insert(const char* str, size_t len)
+{
+	size_t room = m_gapEnd - m_gapStart;
+	if(len > room)
+		len = room;
+
+	memcpy(m_buf + m_gapStart, str, len);
+	m_gapStart += len;
+	return len;
+}
+
+/**
+	@brief Moves the cursor to a position in the line, in one move rather than a character at a time
+
+	@param pos	New position of the cursor, in characters from the start of the line (clamped to the line length)
+ */
+void CLILineBuffer::SetCursor(int pos)
+{
+	if(pos < 0)
+		pos = 0;
+
+	//Moving left: text between the new and old positions moves to the right side of the gap
+	if(pos < m_gapStart)
+	{
+		int n = m_gapStart - pos;
+		memmove(m_buf + m_gapEnd - n, m_buf + pos, n);
+		m_gapStart -= n;
+		m_gapEnd -= n;
+	}
+
+	//Moving right: the start of the right side moves to the left side of the gap
+	else if(pos > m_gapStart)
+	{
+		int n = pos - m_gapStart;
+		if(n > GetRightLength())
+			n = GetRightLength();
+		memmove(m_buf + m_gapStart, m_buf + m_gapEnd, n);
+		m_gapStart += n;
+		m_gapEnd += n;
+	}
+}
+
+/**
+	@brief Moves the cursor to the end of the line, so the whole line is contiguous and null terminated
+
+	@return Pointer to the start of the line
+ */
+char* CLILineBuffer::Compact()
+{
+	int right = GetRightLength();
+	memmove(m_buf + m_gapStart, m_buf + m_gapEnd, right);
+	m_gapStart += right;
+	m_gapEnd = m_size;
+	m_buf[m_gapStart] = '\0';
+	return m_buf;
+}
@@ -0,0 +1,251 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLILineBuffer
+ */
+#ifndef CLILineBuffer_h
+#define CLILineBuffer_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef MAX_LINE_LEN
+
+	/**
+		@brief Default maximum number of characters in a command line (see CLILineBufferStorage)
+
+		Sessions may have shorter or longer lines.
+	 */
+	#define MAX_LINE_LEN 128
+
+#endif
+
+#ifndef MAX_TOKEN_LEN
+
+	/**
+		@brief Maximum number of characters in a single token
+
+		Tokens are no longer limited individually, only by the length of the line. This is kept so that application
+		code sizing buffers for token text still works.
+	 */
+	#define MAX_TOKEN_LEN MAX_LINE_LEN
+
+#endif
+
+static_assert(MAX_LINE_LEN < 0xffff, "Line length must fit in a uint16_t");
+
+/**
+	@brief The command line being edited, stored as a gap buffer
+
+	Text left of the cursor is stored at the start of the buffer, and text right of the cursor at the end, with the
+	free space (the gap) in between. Inserting or deleting at the cursor, and moving the cursor by one character, are
+	all O(1).
+
+	The byte after the end of the buffer is always a null, so the text right of the cursor is always null terminated.
+
+	The buffer is provided by the caller, normally through CLILineBufferStorage.
+ */
+class CLILineBuffer
+{
+public:
+
+	/**
+		@brief Creates an empty line
+
+		@param buf		Storage, which must be size+1 bytes long (for the null terminator)
+		@param size		Maximum number of characters in the line
+	 */
+	CLILineBuffer(char* buf, uint16_t size)
+	: m_buf(buf)
+	, m_size(size)
+	{
+		m_buf[m_size] = '\0';
+		Clear();
+	}
+
+	/**
+		@brief Resets the line to the empty state
+	 */
+	void Clear()
+	{
+		m_gapStart = 0;
+		m_gapEnd = m_size;
+	}
+
+	///@brief Returns the number of characters in the line
+	int Length() const
+	{ return m_gapStart + (m_size - m_gapEnd); }
+
+	///@brief Returns the largest number of characters the line can hold
+	int GetCapacity() const
+	{ return m_size; }
+
+	///@brief Returns true if the line has no characters in it
+	bool IsEmpty() const
+	{ return Length() == 0; }
+
+	///@brief Returns true if there's no room for another character
+	bool IsFull() const
+	{ return m_gapStart == m_gapEnd; }
+
+	///@brief Returns the position of the cursor, in characters from the start of the line
+	int GetCursor() const
+	{ return m_gapStart; }
+
+	///@brief Returns true if the cursor is after the last character of the line
+	bool IsCursorAtEnd() const
+	{ return m_gapEnd == m_size; }
+
+	///@brief Returns the text left of the cursor. It is GetCursor() characters long and not null terminated.
+	const char* GetLeft() const
+	{ return m_buf; }
+
+	///@brief Returns the text right of the cursor, which is null terminated
+	const char* GetRight() const
+	{ return m_buf + m_gapEnd; }
+
+	///@brief Returns the number of characters right of the cursor
+	int GetRightLength() const
+	{ return m_size - m_gapEnd; }
+
+	/**
+		@brief Inserts a character at the cursor and moves the cursor right of it
+
+		@return False if the line is full
+	 */
+	bool Insert(char c)
+	{
+		if(IsFull())
+			return false;
+		m_buf[m_gapStart ++] = c;
+		return true;
+	}
+
+	size_t Insert(const char* str, size_t len);
+
+	/**
+		@brief Deletes the character left of the cursor
+
+		@return False if the cursor is at the start of the line
+	 */
+	bool Backspace()
+	{
+		if(m_gapStart == 0)
+			return false;
+		m_gapStart --;
+		return true;
+	}
+
+	/**
+		@brief Deletes the character right of the cursor
+
+		@return False if the cursor is at the end of the line
+	 */
+	bool Delete()
+	{
+		if(IsCursorAtEnd())
+			return false;
+		m_gapEnd ++;
+		return true;
+	}
+
+	/**
+		@brief Moves the cursor one character left
+
+		@return False if the cursor is at the start of the line
+	 */
+	bool MoveLeft()
+	{
+		if(m_gapStart == 0)
+			return false;
+		m_buf[--m_gapEnd] = m_buf[--m_gapStart];
+		return true;
+	}
+
+	/**
+		@brief Moves the cursor one character right
+
+		@return False if the cursor is at the end of the line
+	 */
+	bool MoveRight()
+	{
+		if(IsCursorAtEnd())
+			return false;
+		m_buf[m_gapStart ++] = m_buf[m_gapEnd ++];
+		return true;
+	}
+
+	void SetCursor(int pos);
+
+	///@brief Deletes everything right of the cursor
+	void DeleteToEnd()
+	{ m_gapEnd = m_size; }
+
+	///@brief Deletes everything left of the cursor
+	void DeleteToStart()
+	{ m_gapStart = 0; }
+
+	char* Compact();
+
+protected:
+
+	///@brief The buffer, plus room for a null terminator
+	char* m_buf;
+
+	///@brief Maximum number of characters in the line
+	uint16_t m_size;
+
+	///@brief Index of the first character of the gap (i.e. the cursor position)
+	uint16_t m_gapStart;
+
+	///@brief Index of the first character after the gap
+	uint16_t m_gapEnd;
+};
+
+/**
+	@brief A CLILineBuffer with statically allocated storage
+
+	@tparam LEN		Maximum number of characters in the line
+ */
+template<uint16_t LEN = MAX_LINE_LEN>
+class CLILineBufferStorage : public CLILineBuffer
+{
+public:
+	CLILineBufferStorage()
+	: CLILineBuffer(m_storage, LEN)
+	{}
+
+protected:
+	char m_storage[LEN + 1];
+};
+
+#endif
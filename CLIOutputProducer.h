@@ -0,0 +1,72 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIOutputProducer
+ */
+#ifndef CLIOutputProducer_h
+#define CLIOutputProducer_h
+
+class CLIOutputStream;
+
+/**
+	@brief Generates a command's output a piece at a time, so it can be paged
+
+	A command with a lot to say (a routing table, a log) passes one of these to CLISessionContext::StartPagedOutput()
+	instead of printing everything at once. The session calls Produce() repeatedly, and stops calling it when the
+	terminal is full or the output stream is congested, so nothing is generated until there's somewhere for it to go.
+
+	The producer must remain valid until Produce() returns false or Abort() is called.
+ */
+class CLIOutputProducer
+{
+public:
+
+	/**
+		@brief Outputs the next piece, ideally one line
+
+		Page boundaries are only checked between calls, so output from a single call is never held back.
+
+		@param stream	Where to print the output
+		@return True if there's more to come
+	 */
+	virtual bool Produce(CLIOutputStream* stream) =0;
+
+	/**
+		@brief Called instead of Produce() if the user quits paging before the output is complete
+
+		The default implementation does nothing.
+	 */
+	virtual void Abort()
+	{}
+};
+
+#endif
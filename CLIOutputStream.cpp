@@ -41,3 +41,76 @@
 void CLIOutputStream::Disconnect()
 {
 }
+
+/**
+	@brief Moves the cursor left by n columns
+
+	Uses backspaces for short moves, since they're a third the size of a CUB sequence.
+ */
+void CLIOutputStream::CursorLeft(int n)
+{
+	if(n <= 0)
+		return;
+
+	if(n <= 3)
+	{
+		for(int i=0; i<n; i++)
+			PutCharacter('\b');
+	}
+	else
+		PutControlSequence(n, 'D');
+}
+
+/**
+	@brief Returns the number of bytes CursorLeft() will send to move n columns
+ */
+int CLIOutputStream::CursorLeftCost(int n)
+{
+	if(n <= 0)
+		return 0;
+	if(n <= 3)
+		return n;
+	return ControlSequenceCost(n);
+}
+
+/**
+	@brief Returns the number of bytes in a control sequence with a single numeric parameter n
+ */
+int CLIOutputStream::ControlSequenceCost(int n)
+{
+	//ESC [ and the final byte, then digits (omitted entirely for 1 since that's the default)
+	int len = 3;
+	if(n == 1)
+		return len;
+	for(; n > 0; n /= 10)
+		len ++;
+	return len;
+}
+
+/**
+	@brief Sends a control sequence (CSI n command), omitting the parameter if it's the default of 1
+ */
+void CLIOutputStream::PutControlSequence(int n, char command)
+{
+	if(n <= 0)
+		return;
+
+	char buf[16];
+	size_t len = 0;
+	buf[len++] = '\x1b';
+	buf[len++] = '[';
+
+	if(n != 1)
+	{
+		//Format digits backwards, then copy them in order
+		char digits[10];
+		int ndigits = 0;
+		for(; n > 0; n /= 10)
+			digits[ndigits++] = '0' + (n % 10);
+		while(ndigits > 0)
+			buf[len++] = digits[--ndigits];
+	}
+
+	buf[len++] = command;
+	PutData(buf, len);
+}
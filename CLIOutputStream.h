@@ -34,6 +34,7 @@
 #ifndef CLIOutputStream_h
 #define CLIOutputStream_h
 
+#include <stddef.h>
 #include <embedded-utils/CharacterDevice.h>
 
 /**
@@ -60,6 +61,31 @@ public:
 	void CursorRight()
 	{ PutString("\x1b[C"); }
 
+	void CursorLeft(int n);
+
+	///@brief Moves the cursor right by n columns (CUF)
+	void CursorRight(int n)
+	{ PutControlSequence(n, 'C'); }
+
+	///@brief Erases from the cursor to the end of the line (EL)
+	void EraseToEndOfLine()
+	{ PutString("\x1b[K"); }
+
+	///@brief Inserts n blank columns at the cursor, shifting the rest of the line right (ICH, VT102 and later)
+	void InsertCharacters(int n)
+	{ PutControlSequence(n, '@'); }
+
+	///@brief Deletes n columns at the cursor, shifting the rest of the line left (DCH, VT102 and later)
+	void DeleteCharacters(int n)
+	{ PutControlSequence(n, 'P'); }
+
+	///@brief Asks the terminal to mark pasted text with ESC [ 200 ~ and ESC [ 201 ~ (xterm and most others since)
+	void EnableBracketedPaste()
+	{ PutString("\x1b[?2004h"); }
+
+	static int CursorLeftCost(int n);
+	static int ControlSequenceCost(int n);
+
 	///@brief CharacterDevice compatibility
 	virtual void PrintBinary(char ch) override
 	{ PutCharacter(ch); }
@@ -78,12 +104,34 @@ public:
 	 */
 	virtual void PutString(const char* str) =0;
 
+	/**
+		@brief Prints a block of characters, which need not be null terminated
+
+		The default implementation calls PutCharacter() for each one. Transports which can do better should override it.
+	 */
+	virtual void PutData(const char* data, size_t len)
+	{
+		for(size_t i=0; i<len; i++)
+			PutCharacter(data[i]);
+	}
+
 	/**
 		@brief Flushes pending content so that it's displayed to the user.
 	 */
 	virtual void Flush() =0;
 
+	/**
+		@brief Returns true if the transport is backed up and the session should stop consuming input for now
+
+		The default implementation always returns false.
+	 */
+	virtual bool IsCongested()
+	{ return false; }
+
 	virtual void Disconnect();
+
+protected:
+	void PutControlSequence(int n, char command);
 };
 
 #endif
@@ -0,0 +1,86 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of clipackednode_t and clipackedtree_t
+ */
+#ifndef CLIPackedTree_h
+#define CLIPackedTree_h
+
+#include <stdint.h>
+
+///@brief Null child index or string offset in a packed tree
+#define CLI_PACKED_NONE 0xffff
+
+///@brief Flag in clipackednode_t::keyword marking the last keyword of a level
+#define CLI_PACKED_LAST 0x8000
+
+/**
+	@brief A single keyword in a packed command tree
+
+	Same content as a clikeyword_t, but with 16-bit offsets instead of pointers, so it's 10 bytes rather than 20 on a
+	32-bit target. Each level is a contiguous run of nodes, the last of which is flagged in its keyword offset.
+ */
+struct clipackednode_t
+{
+	///@brief Offset of the keyword in the string pool, ORed with CLI_PACKED_LAST for the last keyword of a level
+	uint16_t	keyword;
+
+	///@brief Integer identifier used by the command parser
+	uint16_t	id;
+
+	///@brief Index of the first node of the child level, or CLI_PACKED_NONE
+	uint16_t	children;
+
+	///@brief Offset of the help message in the string pool
+	uint16_t	help;
+
+	///@brief Index of the handler for commands ending at or below this keyword, or zero for none
+	uint16_t	handler;
+};
+
+/**
+	@brief A command tree in packed form, normally generated from clikeyword_t tables by cli-packtree
+
+	Levels which are shared between several keywords (the same clikeyword_t array used as children more than once)
+	are stored once, and every string is stored once in a single pool of null terminated strings. The string pool can
+	be at most 32 kB.
+ */
+struct clipackedtree_t
+{
+	///@brief All of the nodes. The top level of the tree starts at node zero.
+	const clipackednode_t*	nodes;
+
+	///@brief String pool
+	const char*				strings;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIPagerOutputStream
+ */
+#include "CLIPagerOutputStream.h"
+#include <string.h>
+
+void CLIPagerOutputStream::PutCharacter(char ch)
+{
+	if( (ch == '\n') && (m_linesLeft > 0) )
+		m_linesLeft --;
+	m_stream->PutCharacter(ch);
+}
+
+void CLIPagerOutputStream::PutString(const char* str)
+{
+	CountLines(str, strlen(str));
+	m_stream->PutString(str);
+}
+
+void CLIPagerOutputStream::PutData(const char* data, size_t len)
+{
+	CountLines(data, len);
+	m_stream->PutData(data, len);
+}
+
+///@brief Counts the newlines in a block of output against the page
+void CLIPagerOutputStream::CountLines(const char* data, size_t len)
+{
+	const char* end = data + len;
+	while( (m_linesLeft > 0) && (data < end) )
+	{
+		data = static_cast<const char*>(memchr(data, '\n', end - data));
+		if(data == NULL)
+			break;
+		m_linesLeft --;
+		data ++;
+	}
+}
@@ -0,0 +1,101 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIPagerOutputStream
+ */
+#ifndef CLIPagerOutputStream_h
+#define CLIPagerOutputStream_h
+
+#include <stdint.h>
+#include "CLIOutputStream.h"
+
+/**
+	@brief A CLIOutputStream which counts lines on their way to another stream, to tell when a page is full
+
+	Nothing is buffered. CLISessionContext puts one between each command and the session's output stream, and stops
+	asking a CLIOutputProducer for more once the page is full.
+ */
+class CLIPagerOutputStream : public CLIOutputStream
+{
+public:
+	CLIPagerOutputStream()
+	: m_stream(nullptr)
+	, m_linesLeft(0)
+	, m_paging(false)
+	{}
+
+	///@brief Sets the stream lines are passed on to
+	void SetStream(CLIOutputStream* stream)
+	{ m_stream = stream; }
+
+	/**
+		@brief Starts a new page
+
+		@param lines	Number of lines which fit on the page, or zero if there's no limit
+	 */
+	void StartPage(uint16_t lines)
+	{
+		m_linesLeft = lines;
+		m_paging = (lines > 0);
+	}
+
+	///@brief Returns true if the page has been filled
+	bool IsPageFull() const
+	{ return m_paging && (m_linesLeft == 0); }
+
+	virtual void PutCharacter(char ch) override;
+	virtual void PutString(const char* str) override;
+	virtual void PutData(const char* data, size_t len) override;
+
+	virtual void Flush() override
+	{ m_stream->Flush(); }
+
+	virtual bool IsCongested() override
+	{ return m_stream->IsCongested(); }
+
+	virtual void Disconnect() override
+	{ m_stream->Disconnect(); }
+
+protected:
+	void CountLines(const char* data, size_t len);
+
+	///@brief The stream being paged
+	CLIOutputStream* m_stream;
+
+	///@brief Number of lines which still fit on the page
+	uint16_t m_linesLeft;
+
+	///@brief True if the page has a limit
+	bool m_paging;
+};
+
+#endif
@@ -29,29 +29,77 @@
 
 /**
 	@file
-	@brief Implementation of CLISessionContext
+	@brief Implementation of CLISessionContextBase
  */
 #include "stdio.h"
 #include "CLISessionContext.h"
 #include "CLIOutputStream.h"
+#include "CLIKeywordIndex.h"
+#include "CLIHistory.h"
+#include "CLIStatistics.h"
+#include "CLITrace.h"
+#include "CLIFilterOutputStream.h"
+#include "CLIOutputProducer.h"
 #include <string.h>
 #include <ctype.h>
 
+/**
+	@brief Counts output in a given category until the end of the scope, then goes back to the previous one
+
+	Does nothing if the session doesn't have statistics.
+ */
+class OutputCategoryScope
+{
+public:
+	OutputCategoryScope(CLIStatistics* stats, clioutputcategory_t category)
+	: m_stats(stats)
+	, m_previous(OUTPUT_ECHO)
+	{
+		if(m_stats)
+		{
+			m_previous = m_stats->GetOutputCategory();
+			m_stats->SetOutputCategory(category);
+		}
+	}
+
+	~OutputCategoryScope()
+	{
+		if(m_stats)
+			m_stats->SetOutputCategory(m_previous);
+	}
+
+protected:
+	CLIStatistics* m_stats;
+	clioutputcategory_t m_previous;
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Setup
 
-void CLISessionContext::Initialize(CLIOutputStream* ctx, const char* username)
+void CLISessionContextBase::Initialize(CLIOutputStream* ctx, const char* username)
 {
-	strncpy(m_username, username, CLI_USERNAME_MAX);
-	m_username[CLI_USERNAME_MAX-1] = 0;
+	strncpy(m_username, username, m_usernameMax);
+	m_username[m_usernameMax-1] = 0;
+	m_line.Clear();
 	m_command.Clear();
+	m_displayedLength = 0;
+	m_historyAge = -1;
+	m_helpNode = CLITreeNode();
+	m_producer = NULL;
+	m_pagerWaiting = false;
+	m_dispatching = false;
+	m_pasteMode = PASTE_NONE;
 
 	m_output = ctx;
-	m_escapeState = STATE_NORMAL;
+	m_keys.Reset();
+	m_frameState = FRAME_LENGTH_LOW;
 
-	m_lastToken = 0;
-	m_currentToken = 0;
-	m_tokenOffset = 0;
+	//Don't use an index built for some other tree (or not built at all). Packed trees can't be indexed.
+	if( (m_index != NULL) &&
+		( m_rootCommands.IsPacked() || (m_index->GetRoot() == NULL) || (m_index->GetRoot() != m_rootCommands.GetRow()) ) )
+	{
+		m_index = NULL;
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -60,513 +108,1759 @@ void CLISessionContext::Initialize(CLIOutputStream* ctx, const char* username)
 /**
 	@brief Handles an incoming keystroke
  */
-void CLISessionContext::OnKeystroke(char c, bool echo)
+void CLISessionContextBase::OnKeystroke(char c, bool echo)
 {
-	//Square bracket in escape sequence
-	if(m_escapeState == STATE_EXPECT_BRACKET)
-	{
-		if(c == '[')
-			m_escapeState = STATE_EXPECT_PAYLOAD;
+	if(m_stats)
+		m_stats->CountKeystrokes(1);
+	if(m_trace)
+		m_trace->Record(&c, 1, GetTimestamp());
 
-		//ignore malformed escape sequences
+	HandleKeystroke(c, echo);
+
+	//All done with whatever we're printing, flush stdout
+	m_output->Flush();
+}
+
+/**
+	@brief Handles a block of incoming keystrokes, such as one packet from a socket
+
+	Equivalent to calling OnKeystroke() on each character, except that output is only flushed once at the end, and
+	runs of characters typed at the end of the line are appended and echoed all at once.
+
+	Stops early if the output stream becomes congested. The caller should hold on to the rest of the input and offer
+	it again once the stream has drained (see IsInputPaused()).
+
+	@return Number of characters consumed
+ */
+size_t CLISessionContextBase::OnKeystrokes(const char* buf, size_t len, bool echo)
+{
+	uint32_t now = m_trace ? GetTimestamp() : 0;
+
+	size_t i = 0;
+	while( (i < len) && !m_output->IsCongested() )
+	{
+		size_t n = AppendCharacters(buf + i, len - i, echo);
+		if(n > 0)
+			i += n;
 		else
-			m_escapeState = STATE_NORMAL;
+		{
+			HandleKeystroke(buf[i], echo);
+			i ++;
+		}
+	}
 
+	if(m_stats)
+		m_stats->CountKeystrokes(i);
+	if(m_trace)
+		m_trace->Record(buf, i, now);
+
+	m_output->Flush();
+	return i;
+}
+
+/**
+	@brief Returns true if the output stream is congested, and input should be held off until it drains
+ */
+bool CLISessionContextBase::IsInputPaused()
+{
+	return m_output->IsCongested();
+}
+
+/**
+	@brief Appends a run of ordinary characters to the line, if the cursor is at the end of it
+
+	@return Number of characters consumed, or zero if the first character needs to go through HandleKeystroke()
+ */
+size_t CLISessionContextBase::AppendCharacters(const char* buf, size_t len, bool echo)
+{
+	if( m_binaryMode || !m_keys.IsIdle() || !m_helpNode.IsNull() || (m_producer != NULL) )
+		return 0;
+
+	//Pasted text isn't echoed until the end of the line, so it can go anywhere in the line
+	if(m_pasteMode != PASTE_NONE)
+	{
+		size_t n = 0;
+		while( (n < len) && CLIKeyDecoder::IsOrdinary(buf[n]) )
+			n ++;
+		if(n > 0)
+		{
+			m_line.Insert(buf, n);
+			m_pasteEcho = echo;
+			m_pasteCR = false;
+		}
+		return n;
+	}
+
+	if(!m_line.IsCursorAtEnd())
+		return 0;
+
+	size_t n = 0;
+	while( (n < len) && CLIKeyDecoder::IsOrdinary(buf[n]) )
+		n ++;
+	if(n == 0)
+		return 0;
+
+	//Characters that don't fit in the line are dropped, same as OnChar()
+	size_t added = m_line.Insert(buf, n);
+	if(echo)
+	{
+		m_output->PutData(buf, added);
+		m_displayedLength += added;
+	}
+
+	return n;
+}
+
+/**
+	@brief Handles a single keystroke, without flushing output
+ */
+void CLISessionContextBase::HandleKeystroke(char c, bool echo)
+{
+	//Not keystrokes at all
+	if(m_binaryMode)
+	{
+		OnFrameByte(c);
 		return;
 	}
 
-	//Escape sequence payload
-	else if(m_escapeState == STATE_EXPECT_PAYLOAD)
+	//Command output is being paged, and the key is for the pager
+	if(m_producer != NULL)
 	{
-		switch(c)
+		OnOutputPagerKey(c);
+		return;
+	}
+
+	//Help is paused at the end of a page, and the key is for the pager
+	if(!m_helpNode.IsNull())
+	{
+		OnHelpPagerKey(c);
+		return;
+	}
+
+	clikeyaction_t key = m_keys.Decode(c);
+
+	//Pasted text doesn't go through the line editor
+	if(m_pasteMode != PASTE_NONE)
+	{
+		OnPastedKey(key, c, echo);
+		return;
+	}
+
+	switch(key)
+	{
+		case KEY_INSERT:
+			OnChar(c, echo);
+			break;
+
+		//Space starts a new token
+		case KEY_SPACE:
+			OnSpace(echo);
+			break;
+
+		//Newline? Execute the command
+		case KEY_ENTER:
+			if(echo)
+				m_output->PutCharacter('\n');
+			if(OnLineReady())
+			{
+				AddToHistory();
+				if(ParseCommand())
+					Dispatch(true);
+			}
+			OnExecuteComplete();
+			break;
+
+		//Tab? Do tab completion
+		case KEY_TAB:
+			OnTabComplete();
+			break;
+
+		//Question mark? Print help text
+		case KEY_HELP:
+			OnHelp();
+			break;
+
+		//Backspace? Delete the current character.
+		//But we might have to move left a token
+		case KEY_BACKSPACE:
+			OnBackspace();
+			break;
+
+		case KEY_DELETE:
+			OnDelete();
+			break;
+
+		case KEY_LEFT:
+			OnArrowLeft();
+			break;
+
+		case KEY_RIGHT:
+			OnArrowRight();
+			break;
+
+		case KEY_UP:
+			OnArrowUp();
+			break;
+
+		case KEY_DOWN:
+			OnArrowDown();
+			break;
+
+		case KEY_HOME:
+			MoveCursor(0);
+			break;
+
+		case KEY_END:
+			MoveCursor(m_line.Length());
+			break;
+
+		case KEY_WORD_LEFT:
+			MoveCursor(FindWordLeft());
+			break;
+
+		case KEY_WORD_RIGHT:
+			MoveCursor(FindWordRight());
+			break;
+
+		case KEY_KILL_TO_END:
+			OnKillToEnd();
+			break;
+
+		case KEY_KILL_TO_START:
+			OnKillToStart();
+			break;
+
+		case KEY_KILL_WORD:
+			OnKillWord();
+			break;
+
+		case KEY_PASTE_START:
+			StartPaste(PASTE_BRACKETED);
+			break;
+
+		//Unbound keys, and the end of a paste we never saw the start of
+		default:
+			break;
+	}
+}
+
+
+/**
+	@brief Parse and execute the current command without printing anything besides what the command generates
+
+	Usable for scripting flows etc. Does nothing if called from a command.
+ */
+void CLISessionContextBase::SilentExecute()
+{
+	if(m_dispatching)
+		return;
+
+	if(OnLineReady() && ParseCommand())
+		Dispatch();
+
+	m_command.Clear();
+	m_line.Clear();
+}
+
+/**
+	@brief Executes a block of newline separated commands, such as a saved configuration
+
+	Each line is tokenized and executed directly, without going through the line editor, so nothing is echoed and
+	editing keys have no special meaning. Blank lines are skipped, and lines which are too long to fit in the line
+	buffer are reported and skipped.
+
+	Any line being edited interactively is discarded, and any paged output still in progress is quit, the same as if
+	the user had quit at the "--More--" prompt.
+
+	Commands can't run scripts, since the script would overwrite the line buffer holding the command's own tokens and
+	pipe filter. If called from a command, nothing is executed and the statistics are all zero.
+
+	@param script	The commands
+	@param len		Length of script
+	@param stats	If not null, filled out with statistics about the run
+ */
+void CLISessionContextBase::ExecuteScript(const char* script, size_t len, cliscriptstats_t* stats)
+{
+	if(m_dispatching)
+	{
+		if(stats)
 		{
-			//B = down, A = up
+			stats->lines = 0;
+			stats->failures = 0;
+			stats->elapsed = 0;
+		}
+		return;
+	}
 
-			case 'C':
-				OnArrowRight();
-				break;
+	uint32_t start = GetTimestamp();
+	uint32_t lines = 0;
+	uint32_t failures = 0;
 
-			case 'D':
-				OnArrowLeft();
-				break;
+	//Quit any paged output, as if the user had quit at the pager prompt
+	if(m_producer != NULL)
+	{
+		OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
+		if(m_pagerWaiting)
+			m_output->PutString("\r\x1b[K");
+		m_producer->Abort();
+		FinishOutput();
+	}
 
-			//ignore unknown escape sequences
-			default:
-				break;
+	m_command.Clear();
+	m_line.Clear();
+	m_displayedLength = 0;
+	m_historyAge = -1;
+
+	const char* end = script + len;
+	while(script < end)
+	{
+		//Find the end of the line, and strip any trailing CR
+		const char* eol = static_cast<const char*>(memchr(script, '\n', end - script));
+		if(eol == NULL)
+			eol = end;
+		size_t linelen = eol - script;
+		if( (linelen > 0) && (script[linelen - 1] == '\r') )
+			linelen --;
+
+		//Skip blank lines
+		size_t i = 0;
+		while( (i < linelen) && (script[i] == ' ') )
+			i ++;
+		if(i < linelen)
+		{
+			lines ++;
+
+			if(linelen > static_cast<size_t>(m_line.GetCapacity()))
+			{
+				OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
+				m_output->Printf("Line too long (at most %d characters allowed)\n", m_line.GetCapacity());
+				failures ++;
+			}
+			else
+			{
+				m_line.Insert(script, linelen);
+				if(OnLineReady() && ParseCommand())
+					Dispatch();
+				else
+					failures ++;
+
+				m_command.Clear();
+				m_line.Clear();
+			}
 		}
 
-		//escape sequence is over
-		m_escapeState = STATE_NORMAL;
+		script = (eol < end) ? eol + 1 : end;
+	}
+
+	if(stats)
+	{
+		stats->lines = lines;
+		stats->failures = failures;
+		stats->elapsed = GetTimestamp() - start;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Paste mode
+
+/**
+	@brief Tells the session whether input is currently arriving faster than anyone could type
+
+	Transports which can tell (for instance, a UART receiving characters back to back) can use this to get paste mode
+	on terminals without bracketed paste (see CLIOutputStream::EnableBracketedPaste()). While it's set, input is
+	handled the same as bracketed paste: lines are not echoed until they're complete, and editing keys are ignored.
+ */
+void CLISessionContextBase::SetBurstInput(bool burst)
+{
+	if(burst)
+	{
+		if( (m_pasteMode == PASTE_NONE) && !m_binaryMode && m_helpNode.IsNull() && (m_producer == NULL) )
+			StartPaste(PASTE_BURST);
+	}
+	else if(m_pasteMode == PASTE_BURST)
+	{
+		EndPaste();
+		m_output->Flush();
+	}
+}
+
+/**
+	@brief Starts handling input as pasted text
+
+	Pasted text is inserted at the cursor without being echoed. Each line is echoed once it's complete, and then
+	executed.
+ */
+void CLISessionContextBase::StartPaste(PasteMode mode)
+{
+	m_pasteMode = mode;
+	m_pasteStart = m_line.GetCursor();
+	m_pasteEcho = true;
+	m_pasteCR = false;
+}
+
+///@brief Goes back to handling input as typed, leaving any incomplete pasted line to be edited
+void CLISessionContextBase::EndPaste()
+{
+	EchoPastedText();
+	m_pasteMode = PASTE_NONE;
+}
+
+///@brief Handles a key while pasting
+void CLISessionContextBase::OnPastedKey(clikeyaction_t key, char c, bool echo)
+{
+	m_pasteEcho = echo;
+
+	//CR LF is one line ending, not two
+	bool cr = m_pasteCR;
+	m_pasteCR = (c == '\r');
+
+	switch(key)
+	{
+		//Show the line, then run it
+		case KEY_ENTER:
+			if( (c == '\n') && cr)
+				break;
+
+			EchoPastedText();
+			if(echo)
+				m_output->PutCharacter('\n');
+
+			//Run to completion, since the rest of the paste would otherwise be taken as keys for the pager
+			if(OnLineReady())
+			{
+				AddToHistory();
+				if(ParseCommand())
+					Dispatch();
+			}
+			OnExecuteComplete();
+			m_pasteStart = 0;
+			break;
+
+		case KEY_BACKSPACE:
+			EchoPastedText();
+			OnBackspace();
+			m_pasteStart = m_line.GetCursor();
+			break;
+
+		//Spaces and tabs separate words, but like typed spaces, never make empty ones
+		case KEY_SPACE:
+		case KEY_TAB:
+			{
+				int cursor = m_line.GetCursor();
+				if( (cursor > 0) && (m_line.GetLeft()[cursor - 1] != ' ') )
+					m_line.Insert(' ');
+			}
+			break;
+
+		case KEY_INSERT:
+		case KEY_HELP:
+			m_line.Insert(c);
+			break;
+
+		//Bracketed paste markers inside a burst
+		case KEY_PASTE_START:
+			m_pasteMode = PASTE_BRACKETED;
+			break;
+
+		case KEY_PASTE_END:
+			EndPaste();
+			break;
+
+		//Editing keys, and other control characters, mean nothing here
+		default:
+			break;
 	}
+}
 
-	//Newline? Execute the command
-	else if( (c == '\r') || (c == '\n') )
+/**
+	@brief Echoes everything pasted since the last echo
+
+	Anything right of the cursor (if the paste started mid line) is redrawn after it.
+ */
+void CLISessionContextBase::EchoPastedText()
+{
+	int cursor = m_line.GetCursor();
+	if(m_pasteEcho && (cursor > m_pasteStart) )
 	{
-		if(echo)
-			m_output->PutCharacter('\n');
-		OnLineReady();
-		if(ParseCommand())
-			OnExecute();
-		OnExecuteComplete();
+		m_output->PutData(m_line.GetLeft() + m_pasteStart, cursor - m_pasteStart);
+		if(m_line.IsCursorAtEnd())
+			m_displayedLength = cursor;
+		else
+			RedrawLineRightOfCursor();
 	}
+	m_pasteStart = cursor;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Binary protocol
+
+/**
+	@brief Switches the session between interactive keystrokes and binary command frames
+
+	In binary mode, input passed to OnKeystroke() or OnKeystrokes() is a stream of frames, each of which is a two byte
+	little endian payload length followed by the payload (see ExecuteFrame()). Nothing is echoed, and no prompt should
+	be printed. OnFrameComplete() is called after each frame.
+ */
+void CLISessionContextBase::SetBinaryMode(bool binary)
+{
+	m_binaryMode = binary;
+	m_frameState = FRAME_LENGTH_LOW;
+	m_command.Clear();
+	m_line.Clear();
+	m_displayedLength = 0;
+}
+
+/**
+	@brief Executes a command which has already been resolved to command IDs, skipping all text parsing
+
+	The payload is a sequence of tokens, each of which is the command ID of a keyword (two bytes, little endian)
+	legal at that position in the tree. For FREEFORM_TOKEN and TEXT_TOKEN, the ID is followed by a one byte length and
+	that many bytes of argument text. The same rules as for text commands apply to missing or extra arguments.
+
+	The payload must not be longer than the line buffer. Commands can't run frames, so this fails if called from one.
+
+	@return True if the frame was a valid command and was executed
+ */
+bool CLISessionContextBase::ExecuteFrame(const uint8_t* payload, size_t len)
+{
+	if(m_dispatching || (len > static_cast<size_t>(m_line.GetCapacity())))
+		return false;
+
+	m_line.Clear();
+	m_line.Insert(reinterpret_cast<const char*>(payload), len);
+	return ExecuteBufferedFrame(len);
+}
+
+/**
+	@brief Handles one byte of input in binary mode
+ */
+void CLISessionContextBase::OnFrameByte(uint8_t b)
+{
+	switch(m_frameState)
+	{
+		case FRAME_LENGTH_LOW:
+			m_frameLength = b;
+			m_frameState = FRAME_LENGTH_HIGH;
+			break;
+
+		case FRAME_LENGTH_HIGH:
+			m_frameLength |= b << 8;
+			m_frameRemaining = m_frameLength;
+
+			//Empty frame can't be a command
+			if(m_frameLength == 0)
+			{
+				m_frameState = FRAME_LENGTH_LOW;
+				OnFrameComplete(false);
+			}
+
+			//Skip frames too big to buffer
+			else if(m_frameLength > m_line.GetCapacity())
+				m_frameState = FRAME_DISCARD;
 
-	//Backspace? Delete the current character.
-	//But we might have to move left a token
-	else if( (c == '\b') || (c == '\x7f') )
-		OnBackspace();
+			else
+			{
+				m_line.Clear();
+				m_frameState = FRAME_PAYLOAD;
+			}
+			break;
+
+		case FRAME_PAYLOAD:
+			m_line.Insert(b);
+			if(--m_frameRemaining == 0)
+			{
+				m_frameState = FRAME_LENGTH_LOW;
+				OnFrameComplete(ExecuteBufferedFrame(m_frameLength));
+			}
+			break;
 
-	//Tab? Do tab completion
-	else if(c == '\t')
-		OnTabComplete();
+		case FRAME_DISCARD:
+			if(--m_frameRemaining == 0)
+			{
+				m_frameState = FRAME_LENGTH_LOW;
+				OnFrameComplete(false);
+			}
+			break;
+	}
+}
+
+///@brief Finds the keyword at one level of the tree with the specified command ID (null if none)
+static CLITreeNode FindKeywordByID(CLITreeNode node, uint16_t id)
+{
+	for(; !node.IsNull(); node = node.GetNext())
+	{
+		if(node.GetID() == id)
+			break;
+	}
+	return node;
+}
+
+/**
+	@brief Validates and executes a frame payload which has been copied into the line buffer
+
+	Argument text is moved down in place and null terminated, so the tokens can point to it.
+ */
+bool CLISessionContextBase::ExecuteBufferedFrame(size_t len)
+{
+	char* buf = m_line.Compact();
+	m_command.Clear();
+
+	CLITreeNode node = m_rootCommands;
+	m_handler = 0;
+	size_t rpos = 0;
+	size_t wpos = 0;
+	bool ok = true;
+	while(rpos < len)
+	{
+		//Look up the keyword
+		if(len - rpos < 2)
+		{
+			ok = false;
+			break;
+		}
+		uint16_t id = static_cast<uint8_t>(buf[rpos]) | (static_cast<uint8_t>(buf[rpos + 1]) << 8);
+		rpos += 2;
+
+		CLITreeNode row = FindKeywordByID(node, id);
+		if(row.IsNull())
+		{
+			ok = false;
+			break;
+		}
+		if(row.GetHandler() != 0)
+			m_handler = row.GetHandler();
+
+		//Arguments carry their own text. Since every argument has at least three bytes of header, the text can be
+		//moved down to make room for the null terminator without overwriting anything we haven't read yet.
+		const char* text = row.GetKeyword();
+		uint16_t textlen = strlen(text);
+		if( (id == FREEFORM_TOKEN) || (id == TEXT_TOKEN) )
+		{
+			if(rpos >= len)
+			{
+				ok = false;
+				break;
+			}
+			textlen = static_cast<uint8_t>(buf[rpos++]);
+			if(textlen > len - rpos)
+			{
+				ok = false;
+				break;
+			}
+
+			memmove(buf + wpos, buf + rpos, textlen);
+			buf[wpos + textlen] = '\0';
+			text = buf + wpos;
+			wpos += textlen + 1;
+			rpos += textlen;
+		}
+
+		if(!m_command.AddToken(text, textlen, id))
+		{
+			ok = false;
+			break;
+		}
+
+		//Text argument must be the last thing in the command
+		node = row.GetChildren();
+		if(id == TEXT_TOKEN)
+		{
+			ok = (rpos == len);
+			node = CLITreeNode();
+			break;
+		}
+	}
+
+	//Empty, or missing arguments?
+	int count = m_command.GetTokenCount();
+	if(count == 0)
+		ok = false;
+	if(ok && !node.IsNull())
+	{
+		if( (node.GetID() == OPTIONAL_TOKEN) && (count < m_command.GetMaxTokens()) )
+			m_command[count].m_commandID = OPTIONAL_TOKEN;
+		else
+			ok = false;
+	}
+
+	//Frames can't be filtered, but a text line that failed to parse may have left a filter set up
+	if(m_filter)
+		m_filter->ClearFilter();
+
+	if(ok)
+		Dispatch();
+
+	m_command.Clear();
+	m_line.Clear();
+	return ok;
+}
+
+///@brief Handles a printable character
+void CLISessionContextBase::OnChar(char c, bool echo)
+{
+	//If the line doesn't have room for another character, abort
+	if(!m_line.Insert(c))
+		return;
+	if(!echo)
+		return;
+
+	//At the end of the line, just echo it
+	int right = m_line.GetRightLength();
+	if(right == 0)
+	{
+		m_output->PutCharacter(c);
+		m_displayedLength ++;
+	}
+
+	//In the middle, either have the terminal open up a column for it or redraw everything to the right
+	else if( (m_terminalCaps & TERM_CAP_INSERT_DELETE) &&
+		(CLIOutputStream::ControlSequenceCost(1) < right + CLIOutputStream::CursorLeftCost(right)) )
+	{
+		m_output->InsertCharacters(1);
+		m_output->PutCharacter(c);
+		m_displayedLength ++;
+	}
+	else
+	{
+		m_output->PutCharacter(c);
+		RedrawLineRightOfCursor();
+	}
+}
+
+/**
+	@brief Handles a tab character
+
+	If the token at the end of the line can only be one keyword, completes it and adds a space. If it could be several,
+	completes as much as they have in common, or lists them if that doesn't add anything. Only the added characters
+	are sent to the terminal.
+ */
+void CLISessionContextBase::OnTabComplete()
+{
+	if(m_rootCommands.IsNull() || !m_line.IsCursorAtEnd() )
+		return;
+
+	int cursor = m_line.GetCursor();
+	if(!m_command.Split(m_line.GetLeft(), cursor))
+	{
+		m_command.Clear();
+		return;
+	}
+
+	//Nothing to complete if an earlier token is bad, or if no keyword can go here
+	int current;
+	CLITreeNode node;
+	uint16_t level;
+	if( (FindCursorLevel(current, node, level) != MATCH_KEYWORD) || node.IsNull() )
+	{
+		m_command.Clear();
+		return;
+	}
+
+	//Starting a new token, so there's nothing to complete. Show what could go here.
+	if(current >= m_command.GetTokenCount())
+	{
+		m_command.Clear();
+		PrintCompletions(node, NULL, 0);
+		return;
+	}
+
+	const char* text = m_command[current].m_text;
+	int len = m_command[current].Length();
+	m_command.Clear();
+
+	CLITreeNode hit;
+	int commonLen;
+	auto result = CompleteKeyword(node, level, text, len, hit, commonLen);
+	if(result == MATCH_NONE)
+		return;
+
+	//Nothing more in common, so list the candidates
+	if( (result == MATCH_AMBIGUOUS) && (commonLen == len) )
+	{
+		PrintCompletions(node, text, len);
+		return;
+	}
+
+	//Add whatever we can. Text points into the line, so don't touch it after this.
+	AppendText(hit.GetKeyword() + len, commonLen - len);
+	if(result == MATCH_KEYWORD)
+		AppendText(" ", 1);
+}
+
+/**
+	@brief Inserts text at the cursor (which must be at the end of the line) and echoes it
+ */
+void CLISessionContextBase::AppendText(const char* text, size_t len)
+{
+	size_t added = m_line.Insert(text, len);
+	m_output->PutData(text, added);
+	m_displayedLength += added;
+}
+
+/**
+	@brief Finds how far a partially typed keyword can be completed
+
+	@param node			The keywords the token is being matched against
+	@param level		Index level for node, if we have an index
+	@param text			The token typed so far
+	@param len			Length of the token, must be nonzero
+	@param hit			On success, a keyword which starts with the completion
+	@param commonLen	On success, length of the prefix shared by every keyword starting with the token
+
+	@return	MATCH_KEYWORD if only one keyword can be meant (or the token is already a complete keyword),
+			MATCH_AMBIGUOUS if there's more than one, or MATCH_NONE if no keyword starts with the token
+ */
+clikeywordmatch_t CLISessionContextBase::CompleteKeyword(
+	CLITreeNode node,
+	uint16_t level,
+	const char* text,
+	int len,
+	CLITreeNode& hit,
+	int& commonLen)
+{
+	//Use the index if we have one
+	if(m_index)
+	{
+		uint16_t row;
+		uint16_t common;
+		auto result = m_index->Complete(level, text, len, row, common);
+		if(result != MATCH_NONE)
+		{
+			hit = node + row;
+			commonLen = common;
+		}
+		return result;
+	}
+
+	//No index, search linearly
+	int count = 0;
+	const char* hitKeyword = NULL;
+	for(auto row = node; !row.IsNull(); row = row.GetNext())
+	{
+		//Wildcards can't be completed
+		uint16_t id = row.GetID();
+		if( (id == FREEFORM_TOKEN) || (id == TEXT_TOKEN) )
+			continue;
+		const char* keyword = row.GetKeyword();
+		if(strncmp(keyword, text, len) != 0)
+			continue;
+
+		//Exact matches are already complete, even if they're also a prefix of something else
+		if(keyword[len] == '\0')
+		{
+			hit = row;
+			commonLen = len;
+			return MATCH_KEYWORD;
+		}
+
+		//Keep track of how much all of the candidates have in common
+		if(count == 0)
+		{
+			hit = row;
+			hitKeyword = keyword;
+			commonLen = strlen(keyword);
+		}
+		else
+		{
+			int same = len;
+			while( (same < commonLen) && (keyword[same] == hitKeyword[same]) )
+				same ++;
+			commonLen = same;
+		}
+		count ++;
+	}
+
+	if(count == 0)
+		return MATCH_NONE;
+	if(count == 1)
+		return MATCH_KEYWORD;
+	return MATCH_AMBIGUOUS;
+}
+
+/**
+	@brief Lists the keywords which could complete a token, then redraws the line
+ */
+void CLISessionContextBase::PrintCompletions(CLITreeNode node, const char* prefix, int prefixLen)
+{
+	OutputCategoryScope scope(m_stats, OUTPUT_HELP);
+	m_output->PutCharacter('\n');
+	for(; !node.IsNull(); node = node.GetNext())
+	{
+		if( (node.GetID() == FREEFORM_TOKEN) || (node.GetID() == TEXT_TOKEN) )
+			continue;
+		const char* keyword = node.GetKeyword();
+		if( (prefixLen > 0) && (strncmp(keyword, prefix, prefixLen) != 0) )
+			continue;
+
+		m_output->PutString(keyword);
+		m_output->PutString("  ");
+	}
+	m_output->PutCharacter('\n');
+
+	RedrawLine();
+}
+
+///@brief Handles a '?' character
+void CLISessionContextBase::OnHelp()
+{
+	if(m_rootCommands.IsNull())
+		return;
+
+	OutputCategoryScope scope(m_stats, OUTPUT_HELP);
+
+	//Split up everything left of the cursor. If there's too much to fit, we can't offer any help.
+	int cursor = m_line.GetCursor();
+	if(!m_command.Split(m_line.GetLeft(), cursor))
+	{
+		m_command.Clear();
+		PrintHelp(CLITreeNode(), 0, NULL, 0);
+		return;
+	}
+
+	//If an earlier token is unrecognized or ambiguous, this shows what it could have been
+	int current;
+	CLITreeNode node;
+	uint16_t level;
+	auto result = FindCursorLevel(current, node, level);
+
+	if( (result != MATCH_WILDCARD) && (current < m_command.GetTokenCount()) )
+		PrintHelp(node, level, m_command[current].m_text, m_command[current].Length());
+	else
+		PrintHelp(node, level, NULL, 0);
+	m_command.Clear();
+}
+
+/**
+	@brief Walks the tokens left of the cursor (already split into m_command) to find where in the tree we are
+
+	@param current	Index of the token the cursor is in, or the token count if the cursor is starting a new one.
+					If an earlier token didn't match, it's set to that token instead.
+	@param node		The keywords the token at current can be (null if nothing can go there)
+	@param level	Index level for node
+
+	@return	MATCH_KEYWORD if all tokens before the current one matched,
+			MATCH_NONE or MATCH_AMBIGUOUS if one of them didn't,
+			MATCH_WILDCARD if one of them is a text argument (which consumes the rest of the line)
+ */
+clikeywordmatch_t CLISessionContextBase::FindCursorLevel(int& current, CLITreeNode& node, uint16_t& level)
+{
+	//If the cursor is in (or at the end of) a word, that's the current token.
+	//If it's after a space, we're about to start a new one.
+	int cursor = m_line.GetCursor();
+	current = m_command.GetTokenCount();
+	if( (cursor > 0) && (m_line.GetLeft()[cursor-1] != ' ') )
+		current --;
+
+	//Go through each token left of the current one
+	node = m_rootCommands;
+	level = 0;
+	for(int i = 0; i < current; i ++)
+	{
+		//Nothing legal after this point
+		if(node.IsNull())
+			break;
+
+		CLITreeNode hit;
+		CLITreeNode other;
+		uint16_t nodeLevel = level;
+		auto result = MatchKeyword(node, level, m_command[i], hit, other);
+		if( (result == MATCH_NONE) || (result == MATCH_AMBIGUOUS) )
+		{
+			current = i;
+			return result;
+		}
+
+		//Text token consumes everything after it
+		if(hit.GetID() == TEXT_TOKEN)
+		{
+			current = i;
+			level = nodeLevel;
+			return MATCH_WILDCARD;
+		}
+
+		node = hit.GetChildren();
+	}
+
+	//Can't start another token if we're out of room
+	if(current >= m_command.GetMaxTokens())
+		node = CLITreeNode();
+
+	return MATCH_KEYWORD;
+}
+
+/**
+	@brief Prints help for the keywords at one level of the tree, then redraws the line
+
+	If the terminal height is known and the listing doesn't fit, it stops at the end of each page until a key is
+	pressed.
+
+	@param node			The keywords to list (null if nothing can go here)
+	@param level		Index level for node, if we have an index
+	@param prefix		Only list keywords starting with this
+	@param prefixLen	Length of prefix
+ */
+void CLISessionContextBase::PrintHelp(CLITreeNode node, uint16_t level, const char* prefix, int prefixLen)
+{
+	m_output->PutString("?\n");
+
+	//If node is null, there's nothing we can do
+	if(node.IsNull())
+	{
+		m_output->PutString("    No help available\n");
+		RedrawLine();
+		return;
+	}
+
+	//Size the keyword column for the whole level, so it doesn't change from page to page
+	if(m_index)
+		m_helpWidth = m_index->GetHelpWidth(level);
+	else
+	{
+		m_helpWidth = 0;
+		for(auto row = node; !row.IsNull(); row = row.GetNext())
+		{
+			int len = strlen(row.GetKeyword());
+			if(len > m_helpWidth)
+				m_helpWidth = len;
+		}
+	}
+
+	m_helpNode = node;
+	m_helpPrefix = prefix;
+	m_helpPrefixLen = prefixLen;
+
+	//Leave room for the line with the '?' and the pager prompt
+	ContinueHelp( (m_terminalRows > 2) ? m_terminalRows - 2 : 0);
+}
+
+/**
+	@brief Prints more of the current help listing
+
+	@param lines	Maximum number of entries to print before pausing, or zero for no limit
+ */
+void CLISessionContextBase::ContinueHelp(int lines)
+{
+	int printed = 0;
+	for(; !m_helpNode.IsNull(); m_helpNode = m_helpNode.GetNext())
+	{
+		//Skip stuff with the wrong prefix
+		if( (m_helpPrefixLen > 0) && (strncmp(m_helpNode.GetKeyword(), m_helpPrefix, m_helpPrefixLen) != 0) )
+			continue;
+
+		//Page is full and there's more to come
+		if( (lines > 0) && (printed == lines) )
+		{
+			m_output->PutString("--More--");
+			return;
+		}
+
+		PrintHelpEntry(m_helpNode);
+		printed ++;
+	}
+
+	m_helpNode = CLITreeNode();
+	RedrawLine();
+}
+
+/**
+	@brief Handles a keystroke while help is paused at the end of a page
+
+	Space shows the next page, enter shows one more line, and anything else stops.
+ */
+void CLISessionContextBase::OnHelpPagerKey(char c)
+{
+	OutputCategoryScope scope(m_stats, OUTPUT_HELP);
+
+	//Get rid of the pager prompt
+	m_output->PutString("\r\x1b[K");
+
+	switch(c)
+	{
+		case ' ':
+			ContinueHelp(m_terminalRows - 1);
+			break;
+
+		case '\r':
+		case '\n':
+			ContinueHelp(1);
+			break;
+
+		default:
+			m_helpNode = CLITreeNode();
+
+			//Swallow the rest of an escape sequence, rather than typing it
+			if(c == '\x1b')
+				m_keys.OnEscape();
+
+			RedrawLine();
+			break;
+	}
+}
+
+/**
+	@brief Prints a single line of help
+ */
+void CLISessionContextBase::PrintHelpEntry(CLITreeNode keyword)
+{
+	static const char spaces[] = "                                ";
+	const int maxPad = sizeof(spaces) - 1;
+
+	m_output->PutData(spaces, 4);
+
+	const char* text = keyword.GetKeyword();
+	int len = strlen(text);
+	m_output->PutData(text, len);
+
+	//Pad out to the help column, with at least two spaces
+	for(int pad = m_helpWidth - len + 2; pad > 0; pad -= maxPad)
+		m_output->PutData(spaces, (pad > maxPad) ? maxPad : pad);
+
+	m_output->PutString(keyword.GetHelp());
+	m_output->PutCharacter('\n');
+}
+
+/**
+	@brief Prints the prompt and the whole line after it (after printing something else), and puts the cursor back
+ */
+void CLISessionContextBase::RedrawLine()
+{
+	OutputCategoryScope scope(m_stats, OUTPUT_REDRAW);
+	PrintPrompt();
+
+	m_output->PutData(m_line.GetLeft(), m_line.GetCursor());
+	m_output->PutString(m_line.GetRight());
+	m_output->CursorLeft(m_line.GetRightLength());
+	m_displayedLength = m_line.Length();
+}
+
+///@brief Handles a backspace character
+void CLISessionContextBase::OnBackspace()
+{
+	//Backspace at the start of the prompt. Ignore it.
+	if(!m_line.Backspace())
+		return;
+
+	//At the end of the line, just rub out the last character
+	if(m_line.IsCursorAtEnd())
+	{
+		m_output->Backspace();
+		m_displayedLength --;
+	}
+
+	//In the middle, move left and then close up the gap
+	else
+	{
+		m_output->CursorLeft(1);
+		if(m_terminalCaps & TERM_CAP_INSERT_DELETE)
+		{
+			m_output->DeleteCharacters(1);
+			m_displayedLength --;
+		}
+		else
+			RedrawLineRightOfCursor();
+	}
+}
+
+///@brief Handles a space character
+void CLISessionContextBase::OnSpace(bool echo)
+{
+	//Ignore leading and consecutive spaces, they'd only make empty tokens
+	int cursor = m_line.GetCursor();
+	if( (cursor == 0) || (m_line.GetLeft()[cursor - 1] == ' ') )
+		return;
+
+	OnChar(' ', echo);
+}
+
+///@brief Handles a left arrow key press
+void CLISessionContextBase::OnArrowLeft()
+{
+	if(m_line.MoveLeft())
+		m_output->CursorLeft(1);
+}
+
+///@brief Handles a right arrow key press
+void CLISessionContextBase::OnArrowRight()
+{
+	//Re-printing the character we're moving over is cheaper than a cursor movement sequence
+	if(m_line.MoveRight())
+		m_output->PutCharacter(m_line.GetLeft()[m_line.GetCursor() - 1]);
+}
+
+///@brief Handles a delete key press, deleting the character right of the cursor
+void CLISessionContextBase::OnDelete()
+{
+	if(!m_line.Delete())
+		return;
+
+	if(m_terminalCaps & TERM_CAP_INSERT_DELETE)
+	{
+		m_output->DeleteCharacters(1);
+		m_displayedLength --;
+	}
+	else
+		RedrawLineRightOfCursor();
+}
+
+/**
+	@brief Moves the cursor to a position in the line, with a single cursor movement rather than one per character
+
+	@param pos	New cursor position, at most the length of the line
+ */
+void CLISessionContextBase::MoveCursor(int pos)
+{
+	int cursor = m_line.GetCursor();
+	if(pos < cursor)
+		m_output->CursorLeft(cursor - pos);
+
+	//Going right, re-printing a few characters is cheaper than a cursor movement sequence
+	else if(pos > cursor)
+	{
+		int n = pos - cursor;
+		if(n <= CLIOutputStream::ControlSequenceCost(n))
+			m_output->PutData(m_line.GetRight(), n);
+		else
+			m_output->CursorRight(n);
+	}
+
+	m_line.SetCursor(pos);
+}
+
+///@brief Returns the position of the start of the word left of the cursor (skipping any spaces in between)
+int CLISessionContextBase::FindWordLeft()
+{
+	const char* left = m_line.GetLeft();
+	int pos = m_line.GetCursor();
+	while( (pos > 0) && (left[pos - 1] == ' ') )
+		pos --;
+	while( (pos > 0) && (left[pos - 1] != ' ') )
+		pos --;
+	return pos;
+}
+
+///@brief Returns the position of the end of the word right of the cursor (skipping any spaces in between)
+int CLISessionContextBase::FindWordRight()
+{
+	const char* right = m_line.GetRight();
+	int len = m_line.GetRightLength();
+	int n = 0;
+	while( (n < len) && (right[n] == ' ') )
+		n ++;
+	while( (n < len) && (right[n] != ' ') )
+		n ++;
+	return m_line.GetCursor() + n;
+}
+
+///@brief Deletes everything left of the cursor
+void CLISessionContextBase::OnKillToStart()
+{
+	int n = m_line.GetCursor();
+	m_line.DeleteToStart();
+	CloseUpLeft(n);
+}
+
+///@brief Deletes the word left of the cursor, and any spaces between it and the cursor
+void CLISessionContextBase::OnKillWord()
+{
+	int n = m_line.GetCursor() - FindWordLeft();
+	for(int i=0; i<n; i++)
+		m_line.Backspace();
+	CloseUpLeft(n);
+}
+
+/**
+	@brief Updates the display after n characters left of the cursor have been deleted from the line
+
+	The gap is closed up with a single redraw, or a single delete sequence if the terminal supports it.
+ */
+void CLISessionContextBase::CloseUpLeft(int n)
+{
+	if(n <= 0)
+		return;
+
+	m_output->CursorLeft(n);
+
+	if( (m_terminalCaps & TERM_CAP_INSERT_DELETE) && !m_line.IsCursorAtEnd() )
+	{
+		m_output->DeleteCharacters(n);
+		m_displayedLength -= n;
+	}
+	else
+		RedrawLineRightOfCursor();
+}
+
+///@brief Deletes everything right of the cursor
+void CLISessionContextBase::OnKillToEnd()
+{
+	if(m_line.IsCursorAtEnd())
+		return;
+
+	m_line.DeleteToEnd();
+	RedrawLineRightOfCursor();
+}
+
+///@brief Handles an up arrow key press, recalling the previous command in the history
+void CLISessionContextBase::OnArrowUp()
+{
+	if( (m_history == nullptr) || (m_historyAge + 1 >= m_history->GetCount()) )
+		return;
 
-	//Question mark? Print help text
-	else if(c == '?')
-		OnHelp();
+	m_historyAge ++;
+	RecallHistory();
+}
 
-	//Space starts a new token
-	else if(c == ' ')
-		OnSpace();
+///@brief Handles a down arrow key press, recalling the next command in the history (or a blank line after the last)
+void CLISessionContextBase::OnArrowDown()
+{
+	if( (m_history == nullptr) || (m_historyAge < 0) )
+		return;
 
-	//Start an escape sequence
-	else if(c == '\x1b')
-		m_escapeState = STATE_EXPECT_BRACKET;
+	m_historyAge --;
+	RecallHistory();
+}
 
-	else
-		OnChar(c, echo);
+/**
+	@brief Replaces the current line with the history entry selected by m_historyAge
 
-	//Update the last-token index
-	for(size_t i=0; i<MAX_TOKENS_PER_COMMAND; i++)
+	The entry is read straight into the line, after finding how much of it is already on screen.
+ */
+void CLISessionContextBase::RecallHistory()
+{
+	int cursor = m_line.GetCursor();
+	const char* old = m_line.Compact();
+	int same = 0;
+	if(m_historyAge >= 0)
 	{
-		//If we type two spaces in the middle of a command we can have an empty command momentarily.
-		//This is totally fine.
-		if(m_command[i].IsEmpty())
-			continue;
-		m_lastToken = i;
+		same = m_history->GetCommonPrefix(m_historyAge, old, m_line.Length());
+		m_history->Get(m_historyAge, m_line);
 	}
+	else
+		m_line.Clear();
 
-	//If we backspaced over the beginning of a token, it's going to be empty.
-	//But we still want to count the empty token as present for now
-	if(m_currentToken > m_lastToken)
-		m_lastToken = m_currentToken;
-
-	//All done with whatever we're printing, flush stdout
-	m_output->Flush();
+	RedrawReplacedLine(cursor, same);
 }
 
 /**
-	@brief Parse and execute the current command without printing anything besides what the command generates
+	@brief Saves the line that was just tokenized to the history
 
-	Usable for scripting flows etc
+	The tokens, and any pipe filter after them, are still in the line separated by spaces and nulls. Words are joined
+	with single spaces, so the entry is the same no matter how the line was spaced.
  */
-void CLISessionContext::SilentExecute()
+void CLISessionContextBase::AddToHistory()
 {
-	OnLineReady();
-	if(ParseCommand())
-		OnExecute();
-
-	m_command.Clear();
+	if(m_history == nullptr)
+		return;
 
-	m_lastToken = 0;
-	m_currentToken = 0;
-	m_tokenOffset = 0;
+	m_history->AddWords(m_line.Compact(), m_line.Length());
 }
 
-///@brief Handles a printable character
-void CLISessionContext::OnChar(char c, bool echo)
+/**
+	@brief Prepares a line to be executed
+
+	Splits the line into tokens in place, so it can't be edited any further until it's cleared.
+
+	@return False if the line could not be tokenized
+ */
+bool CLISessionContextBase::OnLineReady()
 {
-	//If the token doesn't have room for another character, abort
-	char* token = m_command[m_currentToken].m_text;
-	int len = strlen(token);
-	if(len >= (MAX_TOKEN_LEN - 1))
-		return;
+	char* text = m_line.Compact();
+	int len = m_line.Length();
+	if(!ParseFilter(text, len))
+		return false;
 
-	//If we're NOT at the end of the token, we need to move everything right to make room for the new character
-	bool redrawLine = (m_currentToken != m_lastToken);
-	if(m_tokenOffset != len)
+	if(!m_command.Tokenize(text, len))
 	{
-		redrawLine = true;
-		for(int i=len; i > m_tokenOffset; i--)
-			token[i] = token[i-1];
+		OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
+		if(m_stats)
+			m_stats->CountParseFailure(PARSE_TOO_MANY_ARGUMENTS);
+		m_output->Printf("Too many arguments (at most %d words allowed)\n", m_command.GetMaxTokens());
+		return false;
 	}
 
-	//Append the character to the current token and echo it
-	token[m_tokenOffset ++] = c;
-	len++;
-	if(echo)
-		m_output->PutCharacter(c);
-
-	//Update the remainder of the line.
-	if(redrawLine && echo)
-		RedrawLineRightOfCursor();
+	return true;
 }
 
-///@brief Handles a tab character
-void CLISessionContext::OnTabComplete()
-{
-	m_output->Printf("\n*** Tab complete unimplemented ***\n");
-}
+/**
+	@brief Finds a pipe filter at the end of a line, sets up m_filter for it, and cuts it off the line
 
-///@brief Handles a '?' character
-void CLISessionContext::OnHelp()
-{
-	if(m_rootCommands == NULL)
-		return;
+	@param text	The line
+	@param len	Length of the line. Updated to the length of the command before the pipe.
 
-	//If we have NO command, show all legal top level commands and descriptions
-	if(m_command[0].IsEmpty())
+	@return False if there's a pipe, but the filter is missing or not valid
+ */
+bool CLISessionContextBase::ParseFilter(char* text, int& len)
+{
+	if(m_filter == NULL)
+		return true;
+	m_filter->ClearFilter();
+
+	//Look for a '|' on its own
+	int pipe = 0;
+	while( (pipe < len) &&
+		( (text[pipe] != '|') || ( (pipe > 0) && (text[pipe-1] != ' ') ) || ( (pipe+1 < len) && (text[pipe+1] != ' ') ) ) )
 	{
-		PrintHelp(m_rootCommands, NULL);
-		return;
+		pipe ++;
 	}
-
-	//Go through each token and figure out if it matches anything we know about
-	const clikeyword_t* node = m_rootCommands;
-	for(int i = 0; i < MAX_TOKENS_PER_COMMAND; i ++)
+	if(pipe == len)
+		return true;
+
+	//Filter name, then everything after it (less surrounding spaces) is the pattern
+	int name = pipe + 1;
+	while( (name < len) && (text[name] == ' ') )
+		name ++;
+	int nameEnd = name;
+	while( (nameEnd < len) && (text[nameEnd] != ' ') )
+		nameEnd ++;
+	int pattern = nameEnd;
+	while( (pattern < len) && (text[pattern] == ' ') )
+		pattern ++;
+	int patternEnd = len;
+	while( (patternEnd > pattern) && (text[patternEnd-1] == ' ') )
+		patternEnd --;
+
+	OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
+	clifiltermode_t mode;
+	if(!CLIFilterOutputStream::ParseMode(text + name, nameEnd - name, mode))
 	{
-		//If this is the current token, always search it
-		if(i == m_currentToken)
-		{
-			PrintHelp(node, m_command[i].m_text);
-			return;
-		}
-
-		//See what's legal at this position
-		if(m_command[i].IsEmpty())
-		{
-			if(node != NULL)
-			{
-				PrintHelp(node, NULL);
-				return;
-			}
-		}
+		if(m_stats)
+			m_stats->CountParseFailure(PARSE_UNRECOGNIZED);
+		text[nameEnd] = '\0';
+		m_output->Printf("Unrecognized filter: \"%s\" (expected begin, count, exclude or include)\n", text + name);
+		return false;
+	}
+	if( (pattern == patternEnd) && (mode != FILTER_COUNT) )
+	{
+		if(m_stats)
+			m_stats->CountParseFailure(PARSE_INCOMPLETE);
+		m_output->Printf("Incomplete command: filter expects a pattern\n");
+		return false;
+	}
 
-		for(auto row = node; row->keyword != NULL; row++)
-		{
-			//Wildcards always match
-			if(row->id == FREEFORM_TOKEN)
-			{
-			}
+	m_filter->SetFilter(mode, text + pattern, patternEnd - pattern);
+	len = pipe;
+	return true;
+}
 
-			else
-			{
-				//If the token doesn't match the prefix, we're definitely not a hit
-				if(!m_command[i].PrefixMatch(row->keyword))
-					continue;
+/**
+	@brief Cleans up a line after it executes
 
-				//If it matches, but the subsequent token matches too, there's a few options
-				if(m_command[i].PrefixMatch(row[1].keyword))
-				{
-					PrintHelp(node, m_command[i].m_text);
-					return;
-				}
-			}
+	If the command's output is still being paged, the prompt is printed once it's done.
+ */
+void CLISessionContextBase::OnExecuteComplete()
+{
+	m_command.Clear();
+	m_line.Clear();
+	m_displayedLength = 0;
+	m_historyAge = -1;
 
-			//Match!
-			m_command[i].m_commandID = row->id;
-			node = row->children;
-		}
-	}
+	if(m_producer == NULL)
+		PrintPrompt();
 }
 
-///@brief Prints help
-void CLISessionContext::PrintHelp(const clikeyword_t* node, const char* prefix)
+/**
+	@brief Redraws the portion of the line right of the cursor (for editing mid line)
+
+	Anything left over on the terminal from a longer line is erased, and the cursor is put back where it was.
+ */
+void CLISessionContextBase::RedrawLineRightOfCursor()
 {
-	m_output->Printf("?\n");
+	OutputCategoryScope scope(m_stats, OUTPUT_REDRAW);
 
-	//If node is null, there's nothing we can do
-	if(!node)
-		m_output->Printf("    No help available\n");
+	//Draw the remainder of the line
+	int right = m_line.GetRightLength();
+	m_output->PutString(m_line.GetRight());
 
-	//Print the help text for matching commands
-	else
-	{
-		bool filter = true;
-		if( (prefix == nullptr) || (strlen(prefix) == 0) )
-			filter = false;
+	//Clean up anything we may have deleted, then move the cursor back to where it belongs
+	int charsDrawn = right + EraseLeftover(m_displayedLength - m_line.Length(), right);
+	m_output->CursorLeft(charsDrawn);
+	m_displayedLength = m_line.Length();
+}
 
-		m_output->Printf("?\n");
-		for(size_t i=0; node[i].keyword != nullptr; i++)
-		{
-			//Skip stuff with the wrong prefix
-			if(filter)
-			{
-				if(node[i].keyword != strstr(node[i].keyword, prefix))
-					continue;
-			}
+/**
+	@brief Erases characters left over on the terminal after the end of the line
 
-			m_output->Printf("    %-20s %s\n", node[i].keyword, node[i].help);
-		}
-	}
+	Uses either spaces or erase-to-end-of-line, whichever is smaller.
 
-	PrintPrompt();
+	@param leftover	Number of columns to erase, starting at the cursor
+	@param redrawn	Number of columns the cursor has to be moved back over afterwards
 
-	//Re-print the current command
-	//TODO: handle ? at anywhere other than end of command
-	for(int i=0; i<MAX_TOKENS_PER_COMMAND; i++)
-	{
-		if(m_command[i].IsEmpty())
-			continue;
+	@return Number of columns the cursor moved right
+ */
+int CLISessionContextBase::EraseLeftover(int leftover, int redrawn)
+{
+	if(leftover <= 0)
+		return 0;
 
-		if(i > 0)
-			m_output->Printf(" ");
-		m_output->Printf("%s", m_command[i].m_text);
+	int spaceCost = leftover + CLIOutputStream::CursorLeftCost(redrawn + leftover);
+	int eraseCost = 3 + CLIOutputStream::CursorLeftCost(redrawn);
+	if(spaceCost > eraseCost)
+	{
+		m_output->EraseToEndOfLine();
+		return 0;
 	}
 
-	//If the current token is blank, add a trailing space
-	if((m_currentToken > 0) && m_command[m_currentToken].IsEmpty())
-		m_output->Printf(" ");
+	for(int i=0; i<leftover; i++)
+		m_output->PutCharacter(' ');
+	return leftover;
 }
 
-///@brief Handles a backspace character
-void CLISessionContext::OnBackspace()
-{
-	//We're in the middle/end of a token
-	if(m_tokenOffset > 0)
-	{
-		//Delete the character
-		m_output->Backspace();
+/**
+	@brief Redraws the line after all of its text has been replaced, leaving the cursor at the end
 
-		//Move back one character and shift the token left
-		m_tokenOffset --;
-		char* text = m_command[m_currentToken].m_text;
-		for(int i=m_tokenOffset; i<MAX_TOKEN_LEN-1; i++)
-			text[i] = text[i+1];
-	}
+	Only the part of the display that differs from the new text is redrawn.
 
-	//We're at the start of a token, but not the first one
-	else if(m_currentToken > 0)
-	{
-		//Move before the space (already blank, no need to space over it)
-		m_output->CursorLeft();
+	@param cursor	Where the cursor was before the text was replaced
+	@param same		Number of characters at the start of the new text which were already on screen
+ */
+void CLISessionContextBase::RedrawReplacedLine(int cursor, int same)
+{
+	OutputCategoryScope scope(m_stats, OUTPUT_REDRAW);
+
+	const char* text = m_line.GetLeft();
+	int len = m_line.Length();
+
+	//Move the cursor to the end of the common part.
+	//Going right, re-printing characters is cheaper than cursor movement.
+	if(cursor > same)
+		m_output->CursorLeft(cursor - same);
+	else if(cursor < same)
+		m_output->PutData(text + cursor, same - cursor);
+
+	//Draw the rest and clean up after it
+	m_output->PutData(text + same, len - same);
+	m_output->CursorLeft(EraseLeftover(m_displayedLength - len, 0));
+	m_displayedLength = len;
+}
+
+/**
+	@brief Runs a command which has just been parsed successfully
 
-		//Move to end of previous token
-		m_currentToken --;
-		m_tokenOffset = strlen(m_command[m_currentToken].m_text);
+	Calls the handler from the handler table if the command has one, otherwise OnExecute(). If the line ended in a
+	pipe filter, the command's output goes through m_filter. It then goes through m_pager, so paged output (see
+	StartPagedOutput()) knows how much of the page the command has already used.
 
-		//Merge the token we were in with the current one
-		strncpy(
-			m_command[m_currentToken].m_text + m_tokenOffset,
-			m_command[m_currentToken+1].m_text,
-			MAX_TOKEN_LEN - m_tokenOffset);
+	If the session has statistics, the execution time is counted against the ID of the last keyword in the command.
+	This doesn't include paged output generated after the command returns.
 
-		//If we have any tokens to the right of us, move them left
-		for(int i = m_currentToken+1; i < m_lastToken; i++)
-			strncpy(m_command[i].m_text, m_command[i+1].m_text, MAX_TOKEN_LEN);
+	Commands can't run other commands: ExecuteScript(), ExecuteFrame() and SilentExecute() do nothing while one is
+	running, since the output chain, line buffer and tokens are all in use.
 
-		//Blow away the removed token at the far right
-		memset(m_command[m_lastToken].m_text, 0, MAX_TOKEN_LEN);
+	@param interactive	True if the command was typed, and its output can be paged
+ */
+void CLISessionContextBase::Dispatch(bool interactive)
+{
+	OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
+	uint32_t start = m_stats ? GetTimestamp() : 0;
+
+	//Leave room for the command line and the pager prompt on the first page
+	CLIOutputStream* output = m_output;
+	m_pager.SetStream(output);
+	m_pager.StartPage( (interactive && (m_terminalRows > 2)) ? m_terminalRows - 2 : 0);
+	m_output = &m_pager;
+	if( (m_filter != NULL) && m_filter->IsEnabled() )
+	{
+		m_filter->Begin(&m_pager);
+		m_output = m_filter;
 	}
 
-	//Backspace at the start of the prompt. Ignore it.
+	m_producer = NULL;
+	m_dispatching = true;
+	if( (m_handler != 0) && (m_handler < m_handlerCount) && (m_handlers[m_handler] != NULL) )
+		m_handlers[m_handler](this, m_command);
+	else
+		OnExecute();
+	m_dispatching = false;
+
+	m_output = output;
+	if(m_producer != NULL)
+		RunProducer(interactive);
 	else
+		FinishOutput();
+
+	if(m_stats)
 	{
+		uint16_t id = INVALID_COMMAND;
+		for(int i=0; i<m_command.GetTokenCount(); i++)
+		{
+			uint16_t tokenID = m_command[i].m_commandID;
+			if( (tokenID != FREEFORM_TOKEN) && (tokenID != TEXT_TOKEN) )
+				id = tokenID;
+		}
+		m_stats->CountCommand(id, GetTimestamp() - start);
 	}
-
-	RedrawLineRightOfCursor();
 }
 
-///@brief Handles a space character
-void CLISessionContext::OnSpace()
-{
-	//If we're out of token space, stop
-	if(m_lastToken >= (MAX_TOKENS_PER_COMMAND - 1) )
-		return;
+/**
+	@brief Called by a command to have the rest of its output generated by a producer, a page at a time
 
-	//Ignore consecutive spaces - if we already made an empty token between the existing ones,
-	//there's no need to do another one
-	if(m_command[m_currentToken].IsEmpty())
-		return;
+	If the command was typed and the terminal height is known (see SetTerminalRows()), output stops at the end of each
+	page with a "--More--" prompt. Space shows the next page, enter shows one more line, and anything else quits and
+	calls the producer's Abort(). Output also stops while the output stream is congested, and continues on Poll().
+	The prompt isn't printed until the output is complete.
 
-	//OK, we're definitely adding a space. The only question now is where.
-	m_output->PutCharacter(' ' );
+	Commands run by ExecuteScript(), SilentExecute() or binary frames get all of their output at once.
 
-	//If we're at the end of the token, just insert a new token
-	if(m_tokenOffset == m_command[m_currentToken].Length())
-	{
-		//Not empty. Start a new token.
-		m_currentToken ++;
+	The producer is first called after the command returns, and the command's tokens may be gone by then, so it
+	must keep a copy of anything it needs from them.
+ */
+void CLISessionContextBase::StartPagedOutput(CLIOutputProducer* producer)
+{
+	m_producer = producer;
+	m_pagerWaiting = false;
+}
 
-		//If this was the last token, nothing more to do.
-		if(m_currentToken > m_lastToken)
-		{
-			m_tokenOffset = 0;
-			return;
-		}
+/**
+	@brief Generates paged output until it's complete, the page is full, or the output stream is congested
 
-		//If we have tokens to the right, move them right and wipe the current one.
-		for(int i = m_lastToken+1; i > m_currentToken; i-- )
-			strncpy(m_command[i].m_text, m_command[i-1].m_text, MAX_TOKEN_LEN);
-		memset(m_command[m_currentToken].m_text, 0, MAX_TOKEN_LEN);
+	@param interactive	True to stop at the end of the page or when congested, false to run to completion
+ */
+void CLISessionContextBase::RunProducer(bool interactive)
+{
+	OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
 
-		m_tokenOffset = 0;
-	}
+	CLIOutputStream* output = &m_pager;
+	if( (m_filter != NULL) && m_filter->IsEnabled() )
+		output = m_filter;
 
-	//We're in the middle of a token. Need to split it.
-	else
+	while(true)
 	{
-		//If we have tokens to the right, move them right
-		if(m_currentToken < m_lastToken)
+		if(interactive)
 		{
-			for(int i = m_lastToken+1; i > (m_currentToken+1); i-- )
-				strncpy(m_command[i].m_text, m_command[i-1].m_text, MAX_TOKEN_LEN);
-		}
-
-		//Move the right half of the split token into a new one at right
-		strncpy(
-			m_command[m_currentToken+1].m_text,
-			m_command[m_currentToken].m_text + m_tokenOffset,
-			MAX_TOKEN_LEN);
+			if(m_pager.IsPageFull())
+			{
+				m_output->PutString("--More--");
+				m_pagerWaiting = true;
+				return;
+			}
 
-		//Truncate the left half of the split token
-		for(size_t i=m_tokenOffset; i<MAX_TOKEN_LEN; i++)
-			m_command[m_currentToken].m_text[i] = '\0';
+			if(m_output->IsCongested())
+				return;
+		}
 
-		//We're now at the start of the new token
-		m_currentToken ++;
-		m_tokenOffset = 0;
+		if(!m_producer->Produce(output))
+			break;
 	}
 
-	//Definitely have to redraw after doing this!
-	RedrawLineRightOfCursor();
+	FinishOutput();
+}
+
+///@brief Cleans up after a command's output is complete (or paging was quit)
+void CLISessionContextBase::FinishOutput()
+{
+	if( (m_filter != NULL) && m_filter->IsEnabled() )
+		m_filter->End();
 
+	m_producer = NULL;
+	m_pagerWaiting = false;
 }
 
-///@brief Handles a left arrow key press
-void CLISessionContext::OnArrowLeft()
+/**
+	@brief Handles a keystroke while a command's output is being paged
+
+	At the end of a page, space shows the next page, enter shows one more line, and anything else quits. While the
+	output is held off by congestion, 'q' or Ctrl-C quits and everything else is ignored.
+ */
+void CLISessionContextBase::OnOutputPagerKey(char c)
 {
-	//At somewhere other than the start of the current token?
-	//Just move left and go to the previous character
-	if(m_tokenOffset > 0)
-	{
-		m_tokenOffset --;
-		m_output->CursorLeft();
-	}
+	OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
 
-	//Move left, but go to the previous token
-	else if(m_currentToken > 0)
-	{
-		m_output->CursorLeft();
-		m_currentToken --;
-		m_tokenOffset = strlen(m_command[m_currentToken].m_text);
-	}
+	bool quit;
+	if(!m_pagerWaiting)
+		quit = (c == 'q') || (c == '\x03');
 
-	//Start of prompt, can't go left any further
 	else
 	{
-	}
-}
+		//Get rid of the pager prompt
+		m_output->PutString("\r\x1b[K");
+		m_pagerWaiting = false;
 
-///@brief Handles a right arrow key press
-void CLISessionContext::OnArrowRight()
-{
-	//Are we at the end of the current token?
-	char* text = m_command[m_currentToken].m_text;
-	if(m_tokenOffset == (int)strlen(text))
-	{
-		//Is this the last token? Can't go any further
-		if(m_currentToken == m_lastToken)
+		quit = false;
+		switch(c)
 		{
-		}
+			case ' ':
+				m_pager.StartPage( (m_terminalRows > 1) ? m_terminalRows - 1 : 0);
+				break;
 
-		//Move to the start of the next one
-		else
-		{
-			m_tokenOffset = 0;
-			m_currentToken ++;
-			m_output->CursorRight();
+			case '\r':
+			case '\n':
+				m_pager.StartPage(1);
+				break;
+
+			default:
+				quit = true;
+
+				//Swallow the rest of an escape sequence, rather than typing it
+				if(c == '\x1b')
+					m_keys.OnEscape();
+				break;
 		}
 	}
 
-	//Nope, just move one to the right
-	else
+	//Stop the producer, rather than generating the rest and throwing it away
+	if(quit)
 	{
-		m_tokenOffset ++;
-		m_output->CursorRight();
+		m_producer->Abort();
+		FinishOutput();
 	}
-}
+	else
+		RunProducer(true);
 
-///@brief Prepares a line to be executed
-void CLISessionContext::OnLineReady()
-{
-	//If we have any empty tokens, move stuff left to form a canonical command for execution
-	for(int i=0; i<m_lastToken; i++)
-	{
-		if(m_command[i].IsEmpty())
-		{
-			for(int j=i+1; j <= m_lastToken; j++)
-				strncpy(m_command[j-1].m_text, m_command[j].m_text, MAX_TOKEN_LEN);
-			m_lastToken --;
-		}
-	}
+	if(m_producer == NULL)
+		PrintPrompt();
 }
 
-///@brief Cleans up a line after it executes
-void CLISessionContext::OnExecuteComplete()
-{
-	m_command.Clear();
-
-	m_lastToken = 0;
-	m_currentToken = 0;
-	m_tokenOffset = 0;
-
-	PrintPrompt();
-}
+/**
+	@brief Continues paged output which was held off because the output stream was congested
 
-///@brief Redraws the portion of the line right of the cursor (for typing mid line)
-void CLISessionContext::RedrawLineRightOfCursor()
+	Call from the main loop, at least whenever the output stream drains. Does nothing if there's nothing to do.
+ */
+void CLISessionContextBase::Poll()
 {
-	//Draw the remainder of this token
-	char* token = m_command[m_currentToken].m_text;
-	char* restOfToken = token + m_tokenOffset;
-	int charsDrawn = strlen(restOfToken);
-	m_output->PutString(restOfToken);
-
-	//Draw all subsequent tokens
-	for(int i = m_currentToken + 1; i < MAX_TOKENS_PER_COMMAND; i++)
-	{
-		char* tok = m_command[i].m_text;
-		charsDrawn += strlen(tok) + 1;
-		m_output->PutCharacter(' ');
-		m_output->PutString(tok);
-	}
-
-	//Draw a space at the end to clean up anything we may have deleted
-	m_output->PutCharacter(' ');
-	charsDrawn ++;
+	if( (m_producer == NULL) || m_pagerWaiting || m_output->IsCongested() )
+		return;
 
-	//Move the cursor back to where it belongs
-	for(int i=0; i<charsDrawn; i++)
-		m_output->CursorLeft();
+	RunProducer(true);
+	if(m_producer == NULL)
+		PrintPrompt();
+	m_output->Flush();
 }
 
 /**
 	@brief Parses a command to numeric command IDs
  */
-bool CLISessionContext::ParseCommand()
+bool CLISessionContextBase::ParseCommand()
 {
-	if(m_rootCommands == NULL)
+	if(m_rootCommands.IsNull())
 		return false;
 
+	OutputCategoryScope scope(m_stats, OUTPUT_COMMAND);
+
 	//Go through each token and figure out if it matches anything we know about
-	const clikeyword_t* node = m_rootCommands;
-	bool earlyOut = false;
-	for(size_t i = 0; i < MAX_TOKENS_PER_COMMAND; i ++)
+	CLITreeNode node = m_rootCommands;
+	uint16_t level = 0;
+	m_handler = 0;
+	for(int i = 0; i < m_command.GetMaxTokens(); i ++)
 	{
 		//If the node at the end of the command is not NULL, we're missing arguments!
 		if(m_command[i].IsEmpty())
 		{
-			if(node != NULL)
+			if(!node.IsNull())
 			{
 				//See if there is an optional token at the start of the list
 				//(if so, we can skip the unnecessary arguments)
-				if(node->id == OPTIONAL_TOKEN)
+				if(node.GetID() == OPTIONAL_TOKEN)
 				{
 					m_command[i].m_commandID = OPTIONAL_TOKEN;
 					break;
 				}
 
+				//(An empty line isn't an incomplete command, it's nothing at all)
 				if(i > 0)
+				{
+					if(m_stats)
+						m_stats->CountParseFailure(PARSE_INCOMPLETE);
 					m_output->Printf("Incomplete command: \"%s\" expects arguments\n", m_command[i-1].m_text);
+				}
 				return false;
 			}
 
@@ -574,82 +1868,152 @@ bool CLISessionContext::ParseCommand()
 		}
 
 		//If node is null, give an error (too many arguments to command)
-		if(node == NULL)
+		if(node.IsNull())
 		{
+			if(m_stats)
+				m_stats->CountParseFailure(PARSE_TOO_MANY_ARGUMENTS);
 			m_output->Printf("Too many arguments for \"%s\"\n", m_command[0].m_text);
 			return false;
 		}
 
 		m_command[i].m_commandID = INVALID_COMMAND;
 
-		for(auto row = node; row->keyword != NULL; row++)
+		CLITreeNode hit;
+		CLITreeNode other;
+		auto result = MatchKeyword(node, level, m_command[i], hit, other);
+
+		//Fail with an error if the command is ambiguous
+		if(result == MATCH_AMBIGUOUS)
 		{
-			//Wildcards always match.
-			//Freeform token only consumes one token.
-			//Text token consumes all subsequent input.
-			if(row->id == TEXT_TOKEN)
-			{
-				for(size_t j=i+1; j<MAX_TOKENS_PER_COMMAND; j++)
-				{
-					if(strlen(m_command[j].m_text) == 0)
-						break;
+			if(m_stats)
+				m_stats->CountParseFailure(PARSE_AMBIGUOUS);
+			m_output->Printf("Ambiguous command: \"%s\" could mean \"%s\" or \"%s\"\n",
+				m_command[i].m_text,
+				hit.GetKeyword(),
+				other.GetKeyword());
+			return false;
+		}
 
-					strncat(m_command[i].m_text, " ", MAX_TOKEN_LEN-1);
-					strncat(m_command[i].m_text, m_command[j].m_text, MAX_TOKEN_LEN-1);
-				}
+		//Didn't match anything at all, give up
+		if(result == MATCH_NONE)
+		{
+			if(m_stats)
+				m_stats->CountParseFailure(PARSE_UNRECOGNIZED);
+			m_output->Printf("Unrecognized command: \"%s\"\n", m_command[i].m_text);
+			return false;
+		}
 
-				m_command[i].m_commandID = row->id;
-				node = nullptr;
-				earlyOut = true;
-				break;
-			}
-			else if(row->id == FREEFORM_TOKEN)
-			{
-			}
+		//The deepest keyword with a handler gets to run the command
+		uint16_t handler = hit.GetHandler();
+		if(handler != 0)
+			m_handler = handler;
 
-			else
-			{
-				//If the token doesn't match the prefix, we're definitely not a hit
-				if(!m_command[i].PrefixMatch(row->keyword))
-					continue;
+		//Text token consumes all subsequent input
+		if(hit.GetID() == TEXT_TOKEN)
+		{
+			m_command.JoinTokens(i);
+			m_command[i].m_commandID = TEXT_TOKEN;
+			break;
+		}
 
-				//Check for an exact match
-				if(m_command[i].ExactMatch(row->keyword))
-				{
-					m_command[i].m_commandID = row->id;
-					node = row->children;
-					break;
-				}
+		//Match!
+		m_command[i].m_commandID = hit.GetID();
+		node = hit.GetChildren();
+	}
 
-				//If it matches, but the subsequent token matches too, the command is ambiguous!
-				//Fail with an error unless it's an exact match to the first command.
-				else if(m_command[i].PrefixMatch(row[1].keyword))
-				{
-					m_output->Printf("Ambiguous command: \"%s\" could mean \"%s\" or \"%s\"\n",
-						m_command[i].m_text,
-						row->keyword,
-						row[1].keyword);
-					return false;
-				}
-			}
+	//all good
+	return true;
+}
+
+/**
+	@brief Matches a token against one level of the command tree
+
+	Keywords take priority over freeform or text arguments at the same level. If the token exactly matches a keyword
+	it's always accepted, even if it's also a prefix of some other keyword. Keywords may be in any order.
+
+	@param node		The keywords legal at this position
+	@param level	Index of this level in m_index (if present). Updated to the level of the match's children.
+	@param token	The token to match
+	@param hit		The matching row. For ambiguous matches, one of the candidates.
+	@param other	For ambiguous matches, a second candidate
+ */
+clikeywordmatch_t CLISessionContextBase::MatchKeyword(
+	CLITreeNode node,
+	uint16_t& level,
+	CLIToken& token,
+	CLITreeNode& hit,
+	CLITreeNode& other)
+{
+	//Use the index if we have one
+	if(m_index)
+	{
+		uint16_t row;
+		uint16_t otherRow;
+		auto result = m_index->Match(level, token.m_text, token.Length(), row, otherRow);
+		if(result == MATCH_NONE)
+			return result;
+
+		hit = node + row;
+		if(result == MATCH_AMBIGUOUS)
+			other = node + otherRow;
+		else
+			level = m_index->GetChildLevel(level, row);
+		return result;
+	}
 
-			//Match!
-			m_command[i].m_commandID = row->id;
-			node = row->children;
+	//No index, search linearly
+	CLITreeNode wildcard;
+	CLITreeNode first;
+	CLITreeNode second;
+	for(auto row = node; !row.IsNull(); row = row.GetNext())
+	{
+		//Wildcards only match if nothing else does
+		uint16_t id = row.GetID();
+		if( (id == FREEFORM_TOKEN) || (id == TEXT_TOKEN) )
+		{
+			if(wildcard.IsNull())
+				wildcard = row;
+			continue;
 		}
 
-		if(earlyOut)
-			break;
+		//If the token doesn't match the prefix, we're definitely not a hit
+		const char* keyword = row.GetKeyword();
+		if(!token.PrefixMatch(keyword))
+			continue;
 
-		//Didn't match anything at all, give up
-		if(m_command[i].m_commandID == INVALID_COMMAND)
+		//Exact matches always win
+		if(token.ExactMatch(keyword))
 		{
-			m_output->Printf("Unrecognized command: \"%s\"\n", m_command[i].m_text);
-			return false;
+			hit = row;
+			return MATCH_KEYWORD;
 		}
 
+		//Remember the first two prefix matches. Keep looking in case there's an exact match later on.
+		if(first.IsNull())
+			first = row;
+		else if(second.IsNull())
+			second = row;
 	}
 
-	//all good
-	return true;
+	//If it's a prefix of more than one keyword, the command is ambiguous
+	if(!second.IsNull())
+	{
+		hit = first;
+		other = second;
+		return MATCH_AMBIGUOUS;
+	}
+
+	if(!first.IsNull())
+	{
+		hit = first;
+		return MATCH_KEYWORD;
+	}
+
+	if(!wildcard.IsNull())
+	{
+		hit = wildcard;
+		return MATCH_WILDCARD;
+	}
+
+	return MATCH_NONE;
 }
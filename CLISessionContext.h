@@ -29,51 +29,117 @@
 
 /**
 	@file
-	@brief Declaration of CLISessionContext
+	@brief Declaration of CLISessionContextBase, CLISessionContextStorage and CLISessionContext
  */
 #ifndef CLISessionContext_h
 #define CLISessionContext_h
 
 #include <stdint.h>
+#include <stddef.h>
 #include "CLICommand.h"
+#include "CLIKeyword.h"
+#include "CLILineBuffer.h"
+#include "CLIKeyDecoder.h"
+#include "CLITreeNode.h"
+#include "CLIPagerOutputStream.h"
 
 class CLIOutputStream;
+class CLIKeywordIndex;
+class CLIHistory;
+class CLIStatistics;
+class CLITrace;
+class CLIFilterOutputStream;
+class CLIOutputProducer;
 
 #ifndef CLI_USERNAME_MAX
+///@brief Default size of the username buffer, including the null terminator (see CLISessionContextStorage)
 #define CLI_USERNAME_MAX 32
 #endif
 
 /**
-	@brief A single keyword in the CLI command tree
+	@brief Statistics from replaying a script with CLISessionContext::ExecuteScript()
  */
-struct clikeyword_t
+struct cliscriptstats_t
 {
-	///@brief ASCII representation of the unabbreviated keyword
-	const char*			keyword;
+	///@brief Number of non-blank lines processed
+	uint32_t	lines;
 
-	///@brief Integer identifier used by the command parser
-	uint16_t			id;
+	///@brief Number of lines which could not be executed (too long, too many words, or not a valid command)
+	uint32_t	failures;
 
-	///@brief Child nodes for subsequent words
-	const clikeyword_t*	children;
-
-	///@brief Help message
-	const char*			help;
+	///@brief Time taken, in microseconds (zero if GetTimestamp() isn't implemented)
+	uint32_t	elapsed;
 };
 
+class CLISessionContextBase;
+
+/**
+	@brief A command handler, called with the session and the parsed command
+ */
+typedef void (*clihandler_t)(CLISessionContextBase* session, CLICommand& command);
+
 /**
-	@brief A session context for a CLI session
+	@brief A session context for a CLI session, without its buffers
+
+	The line buffer, tokens, and username are provided by the derived class, CLISessionContextStorage, so each session
+	can be sized for its transport. Code which handles sessions of more than one size should refer to them through this
+	class.
  */
-class CLISessionContext
+class CLISessionContextBase
 {
-public:
-	CLISessionContext(const clikeyword_t* root)
-	: m_rootCommands(root)
+protected:
+	/**
+		@brief Creates a session for a command tree
+
+		@param root			Top level keywords of the command tree (a clikeyword_t array or a packed tree)
+		@param index		Optional precomputed index over the same tree, to speed up parsing of large trees.
+							May be shared between sessions. Only clikeyword_t trees can be indexed.
+		@param line			Line buffer
+		@param command		Token storage for the command being executed
+		@param username		Username buffer
+		@param usernameMax	Size of username, including the null terminator
+	 */
+	CLISessionContextBase(
+		CLITreeNode root,
+		const CLIKeywordIndex* index,
+		CLILineBuffer& line,
+		CLICommand& command,
+		char* username,
+		uint16_t usernameMax)
+	: m_line(line)
+	, m_command(command)
+	, m_binaryMode(false)
+	, m_terminalCaps(0)
+	, m_terminalRows(0)
+	, m_history(nullptr)
+	, m_historyAge(-1)
+	, m_username(username)
+	, m_usernameMax(usernameMax)
+	, m_rootCommands(root)
+	, m_index(index)
+	, m_handlers(nullptr)
+	, m_handlerCount(0)
+	, m_stats(nullptr)
+	, m_trace(nullptr)
+	, m_filter(nullptr)
+	, m_producer(nullptr)
+	, m_pagerWaiting(false)
+	, m_dispatching(false)
+	, m_pasteMode(PASTE_NONE)
 	{}
 
+public:
 	virtual void Initialize(CLIOutputStream* ctx, const char* username);
 
 	void OnKeystroke(char c, bool echo = true);
+	size_t OnKeystrokes(const char* buf, size_t len, bool echo = true);
+	bool IsInputPaused();
+	void Poll();
+	void SetBurstInput(bool burst);
+
+	///@brief Returns true if input is being handled as pasted text, rather than typed
+	bool IsPasting() const
+	{ return m_pasteMode != PASTE_NONE; }
 
 	/**
 		@brief Prints the command prompt
@@ -82,32 +148,255 @@ public:
 
 	void SilentExecute();
 
+	/**
+		@brief Sets the table of command handlers referenced by clikeyword_t::handler
+
+		When a command is executed, the handler of the last keyword in it which has a nonzero handler index is called
+		instead of OnExecute(). Entry zero of the table is never used.
+	 */
+	void SetHandlers(const clihandler_t* handlers, uint16_t count)
+	{
+		m_handlers = handlers;
+		m_handlerCount = count;
+	}
+
+	///@brief Returns the output stream (for command handlers)
+	CLIOutputStream* GetOutput()
+	{ return m_output; }
+
+	void StartPagedOutput(CLIOutputProducer* producer);
+
+	///@brief Returns true if a command's paged output is still in progress (see StartPagedOutput())
+	bool IsProducing() const
+	{ return m_producer != nullptr; }
+
+	void ExecuteScript(const char* script, size_t len, cliscriptstats_t* stats = nullptr);
+
+	void SetBinaryMode(bool binary);
+	bool ExecuteFrame(const uint8_t* payload, size_t len);
+
+	/**
+		@brief Returns the current time in microseconds, for statistics
+
+		The default implementation always returns zero. Wraparound is fine, only differences are used.
+	 */
+	virtual uint32_t GetTimestamp()
+	{ return 0; }
+
+	///@brief Optional terminal features that can make redraws cheaper
+	enum TerminalCapabilities
+	{
+		///@brief Insert/delete character (ICH/DCH), supported by VT102 and everything since
+		TERM_CAP_INSERT_DELETE = 1
+	};
+
+	/**
+		@brief Sets which optional terminal features the line editor may use (TERM_CAP_* flags)
+
+		Only VT100 features are used by default.
+	 */
+	void SetTerminalCapabilities(uint8_t caps)
+	{ m_terminalCaps = caps; }
+
+	/**
+		@brief Sets the height of the terminal, so long output can be paged
+
+		Zero (the default) means the height is unknown, and nothing is paged.
+	 */
+	void SetTerminalRows(uint16_t rows)
+	{ m_terminalRows = rows; }
+
+	/**
+		@brief Sets where this session stores its command history (may be null to disable history)
+
+		Each session needs its own history.
+	 */
+	void SetHistory(CLIHistory* history)
+	{ m_history = history; }
+
+	/**
+		@brief Sets where this session counts keystrokes, parse failures and command execution times (may be null)
+
+		To also count output bytes, pass the session a CLIStatisticsOutputStream using the same statistics.
+		Execution times come from GetTimestamp().
+	 */
+	void SetStatistics(CLIStatistics* stats)
+	{ m_stats = stats; }
+
+	/**
+		@brief Sets where this session records its input, with timestamps from GetTimestamp() (may be null)
+
+		The trace can be replayed on a host with cli-replay.
+	 */
+	void SetTrace(CLITrace* trace)
+	{ m_trace = trace; }
+
+	/**
+		@brief Sets the filter used for commands ending in a pipe, like "show log | include error" (may be null)
+
+		Filters are "include", "exclude", "begin" and "count", or any abbreviation of them, followed by a pattern. A '|'
+		is only a pipe if it's a word by itself, and without a filter it's just part of the command. The filter can be
+		shared between sessions, as long as only one of them is executing a command at a time.
+	 */
+	void SetFilter(CLIFilterOutputStream* filter)
+	{ m_filter = filter; }
+
 protected:
 
-	///@brief Handles a line of input being fully entered
+	/**
+		@brief Handles a line of input being fully entered, if it has no handler in the handler table
+
+		Sessions which dispatch every command through the handler table still have to implement this, even if it does
+		nothing, so a session which forgets both can't silently ignore commands.
+	 */
 	virtual void OnExecute() =0;
 
+	void Dispatch(bool interactive = false);
+	void RunProducer(bool interactive);
+	void FinishOutput();
+	void OnOutputPagerKey(char c);
+
+	///@brief Ways paste mode can be entered
+	enum PasteMode
+	{
+		///@brief Not pasting
+		PASTE_NONE,
+
+		///@brief Between ESC [ 200 ~ and ESC [ 201 ~
+		PASTE_BRACKETED,
+
+		///@brief The transport says input is arriving in a burst (see SetBurstInput())
+		PASTE_BURST
+	};
+
+	void StartPaste(PasteMode mode);
+	void EndPaste();
+	void OnPastedKey(clikeyaction_t key, char c, bool echo);
+	void EchoPastedText();
+
+	/**
+		@brief Called after each frame received in binary mode
+
+		The default implementation does nothing. Protocols which acknowledge frames can send the result here.
+
+		@param ok	True if the frame was a valid command and was executed
+	 */
+	virtual void OnFrameComplete(bool ok)
+	{ (void)ok; }
+
+	void OnFrameByte(uint8_t b);
+	bool ExecuteBufferedFrame(size_t len);
+
+	void HandleKeystroke(char c, bool echo);
+	size_t AppendCharacters(const char* buf, size_t len, bool echo);
+
 	void RedrawLineRightOfCursor();
+	void RedrawReplacedLine(int cursor, int same);
+	int EraseLeftover(int leftover, int redrawn);
 
 	void OnExecuteComplete();
 
 	void OnBackspace();
 	void OnTabComplete();
-	void OnSpace();
+	void OnSpace(bool echo = true);
 	void OnChar(char c, bool echo = true);
 	void OnArrowLeft();
 	void OnArrowRight();
-	void OnLineReady();
+	void OnDelete();
+	void MoveCursor(int pos);
+	int FindWordLeft();
+	int FindWordRight();
+	void OnKillToStart();
+	void OnKillWord();
+	void CloseUpLeft(int n);
+	void OnKillToEnd();
+	void OnArrowUp();
+	void OnArrowDown();
+	void RecallHistory();
+	void AddToHistory();
+	bool OnLineReady();
+	bool ParseFilter(char* text, int& len);
 	void OnHelp();
-	void PrintHelp(const clikeyword_t* node, const char* prefix);
+	void PrintHelp(CLITreeNode node, uint16_t level, const char* prefix, int prefixLen);
+	void ContinueHelp(int lines);
+	void OnHelpPagerKey(char c);
+	void PrintHelpEntry(CLITreeNode keyword);
+	void PrintCompletions(CLITreeNode node, const char* prefix, int prefixLen);
+	void RedrawLine();
+	void AppendText(const char* text, size_t len);
+
+	clikeywordmatch_t FindCursorLevel(int& current, CLITreeNode& node, uint16_t& level);
 
 	bool ParseCommand();
 
+	clikeywordmatch_t MatchKeyword(
+		CLITreeNode node,
+		uint16_t& level,
+		CLIToken& token,
+		CLITreeNode& hit,
+		CLITreeNode& other);
+
+	clikeywordmatch_t CompleteKeyword(
+		CLITreeNode node,
+		uint16_t level,
+		const char* text,
+		int len,
+		CLITreeNode& hit,
+		int& commonLen);
+
 	///@brief The output stream
 	CLIOutputStream* m_output;
 
-	///@brief The command currently being
-	CLICommand m_command;
+	///@brief The line currently being edited
+	CLILineBuffer& m_line;
+
+	///@brief The command currently being executed, split into tokens
+	CLICommand& m_command;
+
+	///@brief Number of characters of the line currently displayed on the terminal (after the prompt)
+	int m_displayedLength;
+
+	///@brief True if input is binary frames rather than keystrokes
+	bool m_binaryMode;
+
+	///@brief State machine for binary frame parsing
+	enum
+	{
+		FRAME_LENGTH_LOW,
+		FRAME_LENGTH_HIGH,
+		FRAME_PAYLOAD,
+		FRAME_DISCARD
+	} m_frameState;
+
+	///@brief Payload length of the frame being received
+	uint16_t m_frameLength;
+
+	///@brief Payload bytes left to receive in the current frame
+	uint16_t m_frameRemaining;
+
+	///@brief TERM_CAP_* flags for the terminal
+	uint8_t m_terminalCaps;
+
+	///@brief Height of the terminal, or zero if unknown
+	uint16_t m_terminalRows;
+
+	///@brief Next keyword to consider for a paused help listing, or null if not paging help
+	CLITreeNode m_helpNode;
+
+	///@brief Prefix being listed (points into m_line, which can't be edited while paging)
+	const char* m_helpPrefix;
+
+	///@brief Length of m_helpPrefix
+	int m_helpPrefixLen;
+
+	///@brief Width of the keyword column in the help listing
+	int m_helpWidth;
+
+	///@brief Command history (may be null)
+	CLIHistory* m_history;
+
+	///@brief Which history entry is being displayed (0 is the most recent), or -1 if none
+	int m_historyAge;
 
 	/**
 		@brief Name of the currently logged in user
@@ -115,27 +404,102 @@ protected:
 		Provided by upper layer in case of e.g. SSH. May be blank in case of UART or other transports that do not
 		include authentication.
 	 */
-	char m_username[CLI_USERNAME_MAX];
+	char* m_username;
 
-	///@brief State machine for escape sequence parsing
-	enum
-	{
-		STATE_NORMAL,
-		STATE_EXPECT_BRACKET,
-		STATE_EXPECT_PAYLOAD
-	} m_escapeState;
+	///@brief Size of m_username, including the null terminator
+	uint16_t m_usernameMax;
 
-	///@brief Index of the last token in the command
-	int m_lastToken;
+	///@brief Decoder for keys and escape sequences
+	CLIKeyDecoder m_keys;
 
-	///@brief Index of the token we're currently writing to
-	int m_currentToken;
+	///@brief The root of the command tree
+	CLITreeNode m_rootCommands;
 
-	///@brief Position of the cursor within the current token
-	int m_tokenOffset;
+	///@brief Index over the command tree (may be null)
+	const CLIKeywordIndex* m_index;
 
-	///@brief The root of the command tree
-	const clikeyword_t* m_rootCommands;
+	///@brief Command handler table (may be null)
+	const clihandler_t* m_handlers;
+
+	///@brief Number of entries in m_handlers
+	uint16_t m_handlerCount;
+
+	///@brief Handler index for the command most recently parsed, or zero if none
+	uint16_t m_handler;
+
+	///@brief Performance counters (may be null)
+	CLIStatistics* m_stats;
+
+	///@brief Input recording (may be null)
+	CLITrace* m_trace;
+
+	///@brief Pipe filter (may be null)
+	CLIFilterOutputStream* m_filter;
+
+	///@brief Counts command output against the terminal height
+	CLIPagerOutputStream m_pager;
+
+	///@brief Source of the current command's paged output, or null if there isn't one
+	CLIOutputProducer* m_producer;
+
+	///@brief True if paged output is stopped at the end of a page, waiting for a key
+	bool m_pagerWaiting;
+
+	///@brief True while a command is running (commands can't run other commands)
+	bool m_dispatching;
+
+	///@brief How paste mode was entered, or PASTE_NONE if input is being typed
+	PasteMode m_pasteMode;
+
+	///@brief Position in the line where text pasted since the last echo starts
+	int m_pasteStart;
+
+	///@brief True if pasted text should be echoed
+	bool m_pasteEcho;
+
+	///@brief True if the last pasted character was a CR (so a following LF doesn't make an empty line)
+	bool m_pasteCR;
 };
 
+/**
+	@brief A session context with statically allocated buffers
+
+	The defaults are the MAX_TOKENS_PER_COMMAND, MAX_LINE_LEN, and CLI_USERNAME_MAX macros; a small debug console can
+	use smaller sizes than a full admin session in the same image.
+
+	@tparam TOKENS		Maximum number of words in a command
+	@tparam LINE		Maximum number of characters in a line
+	@tparam USERNAME	Size of the username buffer, including the null terminator
+ */
+template<int TOKENS = MAX_TOKENS_PER_COMMAND, uint16_t LINE = MAX_LINE_LEN, uint16_t USERNAME = CLI_USERNAME_MAX>
+class CLISessionContextStorage : public CLISessionContextBase
+{
+public:
+	static_assert(USERNAME > 0, "Username buffer must have room for a null terminator");
+
+	/**
+		@brief Creates a session for a command tree
+
+		@param root		Top level keywords of the command tree (a clikeyword_t array or a packed tree)
+		@param index	Optional precomputed index over the same tree, to speed up parsing of large trees.
+						May be shared between sessions. Only clikeyword_t trees can be indexed.
+	 */
+	CLISessionContextStorage(CLITreeNode root, const CLIKeywordIndex* index = nullptr)
+	: CLISessionContextBase(root, index, m_lineStorage, m_commandStorage, m_usernameStorage, USERNAME)
+	{}
+
+protected:
+	CLILineBufferStorage<LINE> m_lineStorage;
+	CLICommandStorage<TOKENS> m_commandStorage;
+	char m_usernameStorage[USERNAME];
+};
+
+/**
+	@brief A session context with the default buffer sizes
+
+	Sessions which don't need their own sizes can derive from this, constructing it from the root of the command tree
+	and optionally an index.
+ */
+typedef CLISessionContextStorage<> CLISessionContext;
+
 #endif
@@ -0,0 +1,179 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLISessionPool
+ */
+#ifndef CLISessionPool_h
+#define CLISessionPool_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include "CLISessionContext.h"
+
+/**
+	@brief A fixed capacity pool of sessions, all sharing one command tree and (optionally) one index
+
+	Sessions are constructed in place in statically allocated slots when acquired, and destroyed when released. Both
+	are O(1), using a free list threaded through the unused slots.
+
+	@tparam T	Session class. Must be constructible from (CLITreeNode root, const CLIKeywordIndex* index).
+	@tparam N	Maximum number of concurrent sessions
+ */
+template<class T, uint8_t N>
+class CLISessionPool
+{
+public:
+	static_assert(N > 0, "Session pool must have at least one slot");
+
+	/**
+		@brief Creates an empty pool
+
+		@param root		Top level keywords of the command tree (a clikeyword_t array or a packed tree)
+		@param index	Optional index over the same tree
+	 */
+	CLISessionPool(CLITreeNode root, const CLIKeywordIndex* index = nullptr)
+	: m_root(root)
+	, m_index(index)
+	, m_firstFree(0)
+	, m_inUse(0)
+	{
+		for(uint8_t i=0; i<N; i++)
+		{
+			m_next[i] = i + 1;
+			m_used[i] = false;
+		}
+	}
+
+	~CLISessionPool()
+	{
+		for(uint8_t i=0; i<N; i++)
+		{
+			if(m_used[i])
+				Slot(i)->~T();
+		}
+	}
+
+	/**
+		@brief Constructs a new session in a free slot
+
+		The caller must still call Initialize() on it with the session's output stream.
+
+		@return The session, or nullptr if the pool is full
+	 */
+	T* Acquire()
+	{
+		if(m_firstFree == N)
+			return nullptr;
+
+		uint8_t i = m_firstFree;
+		m_firstFree = m_next[i];
+		m_used[i] = true;
+		m_inUse ++;
+		return new(m_storage[i]) T(m_root, m_index);
+	}
+
+	/**
+		@brief Destroys a session and returns its slot to the pool
+
+		Pointers which were not returned by Acquire() on this pool, or have already been released, are ignored.
+	 */
+	void Release(T* session)
+	{
+		int i = IndexOf(session);
+		if( (i < 0) || !m_used[i] )
+			return;
+
+		session->~T();
+		m_used[i] = false;
+		m_next[i] = m_firstFree;
+		m_firstFree = i;
+		m_inUse --;
+	}
+
+	/**
+		@brief Returns the slot number of a session (stable for the session's lifetime), or -1 if not from this pool
+	 */
+	int IndexOf(const T* session) const
+	{
+		uintptr_t p = reinterpret_cast<uintptr_t>(session);
+		uintptr_t base = reinterpret_cast<uintptr_t>(&m_storage[0]);
+		if( (p < base) || (p >= base + sizeof(m_storage)) )
+			return -1;
+		if( (p - base) % sizeof(T) )
+			return -1;
+		return (p - base) / sizeof(T);
+	}
+
+	///@brief Returns the session in a slot, or nullptr if the slot is free
+	T* GetSession(uint8_t i)
+	{
+		if( (i >= N) || !m_used[i] )
+			return nullptr;
+		return Slot(i);
+	}
+
+	///@brief Returns the number of sessions currently in use
+	uint8_t GetInUse() const
+	{ return m_inUse; }
+
+	///@brief Returns the maximum number of concurrent sessions
+	static constexpr uint8_t GetCapacity()
+	{ return N; }
+
+protected:
+	T* Slot(uint8_t i)
+	{ return reinterpret_cast<T*>(m_storage[i]); }
+
+	///@brief Storage for the sessions themselves
+	alignas(T) uint8_t m_storage[N][sizeof(T)];
+
+	///@brief Command tree shared by all sessions
+	CLITreeNode m_root;
+
+	///@brief Index shared by all sessions
+	const CLIKeywordIndex* m_index;
+
+	///@brief Next free slot after each free slot (N for end of list)
+	uint8_t m_next[N];
+
+	///@brief True for each slot holding a live session
+	bool m_used[N];
+
+	///@brief First free slot (N if the pool is full)
+	uint8_t m_firstFree;
+
+	///@brief Number of live sessions
+	uint8_t m_inUse;
+};
+
+#endif
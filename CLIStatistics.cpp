@@ -0,0 +1,194 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLIStatistics
+ */
+#include "CLIStatistics.h"
+#include "CLIOutputStream.h"
+#include <string.h>
+
+/**
+	@brief Creates a set of counters, all zero
+
+	@param histograms	Storage for execution time histograms
+	@param count		Number of entries in histograms
+	@param parent		Counters which should also count everything counted here (may be null)
+ */
+CLIStatistics::CLIStatistics(clilatencyhistogram_t* histograms, uint16_t count, CLIStatistics* parent)
+	: m_parent(parent)
+	, m_histograms(histograms)
+	, m_histogramCount(count)
+	, m_category(OUTPUT_ECHO)
+{
+	Clear();
+}
+
+/**
+	@brief Resets all counters to zero, and frees all histograms
+
+	Doesn't affect the parent.
+ */
+void CLIStatistics::Clear()
+{
+	m_histogramsUsed = 0;
+	m_keystrokes = 0;
+	m_untrackedCommands = 0;
+	memset(m_outputBytes, 0, sizeof(m_outputBytes));
+	memset(m_parseFailures, 0, sizeof(m_parseFailures));
+}
+
+///@brief Counts input bytes processed
+void CLIStatistics::CountKeystrokes(uint32_t n)
+{
+	for(auto s = this; s != nullptr; s = s->m_parent)
+		s->m_keystrokes += n;
+}
+
+///@brief Counts bytes of output
+void CLIStatistics::CountOutput(clioutputcategory_t category, uint32_t n)
+{
+	for(auto s = this; s != nullptr; s = s->m_parent)
+		s->m_outputBytes[category] += n;
+}
+
+///@brief Counts a command which failed to parse
+void CLIStatistics::CountParseFailure(cliparsefailure_t type)
+{
+	for(auto s = this; s != nullptr; s = s->m_parent)
+		s->m_parseFailures[type] ++;
+}
+
+/**
+	@brief Counts a command being executed
+
+	@param id		Command ID
+	@param elapsed	Execution time in microseconds
+ */
+void CLIStatistics::CountCommand(uint16_t id, uint32_t elapsed)
+{
+	//Bucket is the number of significant bits in the time
+	uint8_t bucket = 0;
+	for(uint32_t t = elapsed; (t != 0) && (bucket < CLI_LATENCY_BUCKETS - 1); t >>= 1)
+		bucket ++;
+
+	for(auto s = this; s != nullptr; s = s->m_parent)
+	{
+		auto hist = s->FindHistogram(id);
+		if(hist == nullptr)
+		{
+			s->m_untrackedCommands ++;
+			continue;
+		}
+
+		hist->buckets[bucket] ++;
+		if(elapsed > hist->maxTime)
+			hist->maxTime = elapsed;
+	}
+}
+
+/**
+	@brief Finds the histogram for a command ID, claiming a free one if it doesn't have one yet
+
+	@return The histogram, or null if they're all in use
+ */
+clilatencyhistogram_t* CLIStatistics::FindHistogram(uint16_t id)
+{
+	for(uint16_t i=0; i<m_histogramsUsed; i++)
+	{
+		if(m_histograms[i].id == id)
+			return &m_histograms[i];
+	}
+
+	if(m_histogramsUsed == m_histogramCount)
+		return nullptr;
+
+	auto hist = &m_histograms[m_histogramsUsed ++];
+	hist->id = id;
+	hist->maxTime = 0;
+	memset(hist->buckets, 0, sizeof(hist->buckets));
+	return hist;
+}
+
+/**
+	@brief Prints all of the counters in human readable form, for use by a "show" command
+
+	Execution times are summarized as a count, the median and 99th percentile (upper bounds of the histogram buckets
+	they fall into), and the maximum.
+ */
+void CLIStatistics::Print(CLIOutputStream* stream) const
+{
+	static const char* const outputNames[OUTPUT_CATEGORY_COUNT] = { "echo", "redraw", "help", "command" };
+	static const char* const failureNames[PARSE_FAILURE_COUNT] =
+		{ "ambiguous", "incomplete", "unrecognized", "too many arguments" };
+
+	stream->Printf("Keystrokes: %d\n", m_keystrokes);
+
+	stream->Printf("Output bytes:\n");
+	for(int i=0; i<OUTPUT_CATEGORY_COUNT; i++)
+		stream->Printf("    %-20s %d\n", outputNames[i], m_outputBytes[i]);
+
+	stream->Printf("Parse failures:\n");
+	for(int i=0; i<PARSE_FAILURE_COUNT; i++)
+		stream->Printf("    %-20s %d\n", failureNames[i], m_parseFailures[i]);
+
+	stream->Printf("Command times (us):\n");
+	stream->Printf("    id         count     p50     p99     max\n");
+	for(uint16_t i=0; i<m_histogramsUsed; i++)
+	{
+		auto& hist = m_histograms[i];
+
+		uint32_t count = 0;
+		for(int j=0; j<CLI_LATENCY_BUCKETS; j++)
+			count += hist.buckets[j];
+
+		//Find the buckets the percentiles fall into
+		uint32_t p50 = 0;
+		uint32_t p99 = 0;
+		uint32_t seen = 0;
+		for(int j=0; j<CLI_LATENCY_BUCKETS; j++)
+		{
+			if(hist.buckets[j] == 0)
+				continue;
+			seen += hist.buckets[j];
+
+			uint32_t bound = (j == CLI_LATENCY_BUCKETS - 1) ? hist.maxTime : (1u << j);
+			if( (p50 == 0) && (seen * 2 >= count) )
+				p50 = bound;
+			if( (p99 == 0) && (seen * 100 >= count * 99) )
+				p99 = bound;
+		}
+
+		stream->Printf("    0x%04x %9d %7d %7d %7d\n", hist.id, count, p50, p99, hist.maxTime);
+	}
+	if(m_untrackedCommands)
+		stream->Printf("    (%d more commands not tracked)\n", m_untrackedCommands);
+}
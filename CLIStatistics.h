@@ -0,0 +1,214 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIStatistics
+ */
+#ifndef CLIStatistics_h
+#define CLIStatistics_h
+
+#include <stdint.h>
+
+class CLIOutputStream;
+
+#ifndef CLI_LATENCY_BUCKETS
+#define CLI_LATENCY_BUCKETS 16
+#endif
+
+/**
+	@brief Kinds of output counted by CLIStatistics
+ */
+enum clioutputcategory_t
+{
+	///@brief Typed characters echoed back, cursor movement, and prompts
+	OUTPUT_ECHO,
+
+	///@brief Redrawing the line after editing, recalling history, or completing a keyword
+	OUTPUT_REDRAW,
+
+	///@brief Help text and completion lists
+	OUTPUT_HELP,
+
+	///@brief Output from commands, including parse errors
+	OUTPUT_COMMAND,
+
+	OUTPUT_CATEGORY_COUNT
+};
+
+/**
+	@brief Reasons a command could not be parsed
+ */
+enum cliparsefailure_t
+{
+	///@brief A token was an abbreviation of more than one keyword
+	PARSE_AMBIGUOUS,
+
+	///@brief The command ended where more arguments were required
+	PARSE_INCOMPLETE,
+
+	///@brief A token didn't match anything legal at its position
+	PARSE_UNRECOGNIZED,
+
+	///@brief There were more tokens than the command takes, or than fit in a CLICommand
+	PARSE_TOO_MANY_ARGUMENTS,
+
+	PARSE_FAILURE_COUNT
+};
+
+/**
+	@brief Execution time histogram for one command ID
+ */
+struct clilatencyhistogram_t
+{
+	///@brief The command ID (of the last keyword in the command)
+	uint16_t	id;
+
+	///@brief Longest execution time seen, in microseconds
+	uint32_t	maxTime;
+
+	/**
+		@brief Number of executions by time
+
+		Bucket 0 counts executions under 1 μs, bucket n those from 2^(n-1) up to 2^n μs. The last bucket also counts
+		everything longer.
+	 */
+	uint32_t	buckets[CLI_LATENCY_BUCKETS];
+};
+
+/**
+	@brief Performance counters for one or more CLI sessions
+
+	Counts keystrokes, output bytes by category, parse failures by type, and command execution times. Everything is
+	in fixed size arrays, so nothing is allocated.
+
+	Counters may be chained: anything counted is also counted by the parent (if any). A typical setup is one
+	CLIStatistics per session, each with a shared global one as its parent.
+
+	Execution times are histogrammed by command ID. The first commands executed claim the histograms, and commands
+	executed once they've all been claimed are only counted by GetUntrackedCommands().
+
+	Output bytes are only counted if the session's output goes through a CLIStatisticsOutputStream.
+ */
+class CLIStatistics
+{
+public:
+	CLIStatistics(clilatencyhistogram_t* histograms, uint16_t count, CLIStatistics* parent = nullptr);
+
+	void Clear();
+
+	void CountKeystrokes(uint32_t n);
+	void CountOutput(clioutputcategory_t category, uint32_t n);
+	void CountParseFailure(cliparsefailure_t type);
+	void CountCommand(uint16_t id, uint32_t elapsed);
+
+	///@brief Sets the category for output counted by CLIStatisticsOutputStream
+	void SetOutputCategory(clioutputcategory_t category)
+	{ m_category = category; }
+
+	///@brief Returns the category for output counted by CLIStatisticsOutputStream
+	clioutputcategory_t GetOutputCategory() const
+	{ return m_category; }
+
+	///@brief Returns the number of input bytes processed
+	uint32_t GetKeystrokes() const
+	{ return m_keystrokes; }
+
+	///@brief Returns the number of bytes of output in a category
+	uint32_t GetOutputBytes(clioutputcategory_t category) const
+	{ return m_outputBytes[category]; }
+
+	///@brief Returns the number of commands which failed to parse for a given reason
+	uint32_t GetParseFailures(cliparsefailure_t type) const
+	{ return m_parseFailures[type]; }
+
+	///@brief Returns the number of histograms which have been claimed by a command ID
+	uint16_t GetHistogramCount() const
+	{ return m_histogramsUsed; }
+
+	///@brief Returns a histogram (up to GetHistogramCount())
+	const clilatencyhistogram_t& GetHistogram(uint16_t i) const
+	{ return m_histograms[i]; }
+
+	///@brief Returns the number of commands executed which didn't get a histogram
+	uint32_t GetUntrackedCommands() const
+	{ return m_untrackedCommands; }
+
+	void Print(CLIOutputStream* stream) const;
+
+protected:
+	clilatencyhistogram_t* FindHistogram(uint16_t id);
+
+	///@brief Counters which also count everything counted by this one (may be null)
+	CLIStatistics* m_parent;
+
+	///@brief Histogram storage
+	clilatencyhistogram_t* m_histograms;
+
+	///@brief Number of entries in m_histograms
+	uint16_t m_histogramCount;
+
+	///@brief Number of entries in m_histograms claimed so far
+	uint16_t m_histogramsUsed;
+
+	///@brief Category for counted output
+	clioutputcategory_t m_category;
+
+	///@brief Input bytes processed
+	uint32_t m_keystrokes;
+
+	///@brief Output bytes by category
+	uint32_t m_outputBytes[OUTPUT_CATEGORY_COUNT];
+
+	///@brief Parse failures by type
+	uint32_t m_parseFailures[PARSE_FAILURE_COUNT];
+
+	///@brief Commands executed which didn't get a histogram
+	uint32_t m_untrackedCommands;
+};
+
+/**
+	@brief A CLIStatistics with statically allocated histograms
+
+	@tparam COMMANDS	Number of command IDs to keep execution time histograms for
+ */
+template<uint16_t COMMANDS>
+class CLIStatisticsStorage : public CLIStatistics
+{
+public:
+	CLIStatisticsStorage(CLIStatistics* parent = nullptr)
+	: CLIStatistics(m_storage, COMMANDS, parent)
+	{}
+
+protected:
+	clilatencyhistogram_t m_storage[COMMANDS];
+};
+
+#endif
@@ -0,0 +1,77 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLIStatisticsOutputStream
+ */
+#ifndef CLIStatisticsOutputStream_h
+#define CLIStatisticsOutputStream_h
+
+#include "CLIOutputStream.h"
+#include "CLIStatistics.h"
+
+/**
+	@brief A CLIOutputStream which counts bytes on their way to another stream
+
+	Bytes are counted in the statistics' current output category, which CLISessionContext sets as it goes (see
+	CLISessionContext::SetStatistics()). Counting happens before any \n to \r\n translation done by the wrapped stream.
+ */
+class CLIStatisticsOutputStream : public CLIOutputStream
+{
+public:
+	CLIStatisticsOutputStream(CLIOutputStream* stream, CLIStatistics* stats)
+	: m_stream(stream)
+	, m_stats(stats)
+	{}
+
+	virtual void PutCharacter(char ch) override;
+	virtual void PutString(const char* str) override;
+	virtual void PutData(const char* data, size_t len) override;
+
+	virtual void Flush() override
+	{ m_stream->Flush(); }
+
+	virtual bool IsCongested() override
+	{ return m_stream->IsCongested(); }
+
+	virtual void Disconnect() override
+	{ m_stream->Disconnect(); }
+
+protected:
+
+	///@brief The stream being counted
+	CLIOutputStream* m_stream;
+
+	///@brief Where to count
+	CLIStatistics* m_stats;
+};
+
+#endif
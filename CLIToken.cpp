@@ -46,18 +46,7 @@ bool CLIToken::PrefixMatch(const char* fullcommand)
 	if(fullcommand == NULL)
 		return false;
 
-	for(size_t i = 0; i < MAX_TOKEN_LEN; i++)
-	{
-		//End of input with no mismatches? It's a match
-		if(m_text[i] == '\0')
-			return true;
-
-		//Early-out on the first mismatch
-		if(m_text[i] != fullcommand[i])
-			return false;
-	}
-
-	return true;
+	return (0 == strncmp(m_text, fullcommand, m_length) );
 }
 
 /**
@@ -70,5 +59,5 @@ bool CLIToken::ExactMatch(const char* fullcommand)
 	if(fullcommand == NULL)
 		return false;
 
-	return (0 == strcmp(m_text, fullcommand) );
+	return (0 == strncmp(m_text, fullcommand, m_length) ) && (fullcommand[m_length] == '\0');
 }
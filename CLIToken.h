@@ -37,13 +37,6 @@
 #include <stdint.h>
 #include <string.h>
 
-#ifndef MAX_TOKEN_LEN
-
-	///@brief Maximum number of characters in a single token
-	#define MAX_TOKEN_LEN 32
-
-#endif
-
 ///@brief Empty string or otherwise malformed
 #define INVALID_COMMAND 0xffff
 
@@ -58,12 +51,17 @@
 
 /**
 	@brief A single token within a command
+
+	Tokens don't own any storage, they point into the command line they were split from. Once a line has been
+	tokenized for execution each token is null terminated, but tokens produced while the line is still being edited
+	(e.g. for help) are not, so internal code must always respect Length().
  */
 class CLIToken
 {
 public:
 
 	CLIToken()
+	: m_epoch(0)
 	{
 		Clear();
 	}
@@ -71,21 +69,22 @@ public:
 	/**
 		@brief Returns true if the token is empty
 	 */
-	bool IsEmpty()
-	{ return strlen(m_text) == 0; }
+	bool IsEmpty() const
+	{ return m_length == 0; }
 
 	/**
 		@brief Returns the length of this token, in characters
 	 */
-	int Length()
-	{ return strlen(m_text); }
+	int Length() const
+	{ return m_length; }
 
 	/**
 		@brief Resets this token to the empty state
 	 */
 	void Clear()
 	{
-		memset(m_text, 0, MAX_TOKEN_LEN);
+		m_text = "";
+		m_length = 0;
 		m_commandID = INVALID_COMMAND;
 	}
 
@@ -93,7 +92,7 @@ public:
 		@brief Helper operator for string matching
 	 */
 	bool operator==(const char* rhs)
-	{ return strcmp(m_text, rhs) == 0; }
+	{ return ExactMatch(rhs); }
 
 	bool PrefixMatch(const char* fullcommand);
 	bool ExactMatch(const char* fullcommand);
@@ -101,10 +100,16 @@ public:
 public:
 
 	///@brief Text representation of the token
-	char m_text[MAX_TOKEN_LEN];
+	const char* m_text;
 
 	///@brief Parsed command ID (if matched) or INVALID_TOKEN otherwise
 	uint16_t m_commandID;
+
+	///@brief Number of characters in m_text
+	uint16_t m_length;
+
+	///@brief Value of CLICommand::m_epoch when this token was last cleared or set
+	uint8_t m_epoch;
 };
 
 #endif
@@ -0,0 +1,169 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Implementation of CLITrace
+ */
+#include "CLITrace.h"
+
+///@brief Magic number and format version at the start of every trace
+static const uint8_t g_traceHeader[CLITrace::HEADER_SIZE] = { 'C', 'L', 'T', 1 };
+
+/**
+	@brief Creates a trace
+
+	@param buf		Trace storage
+	@param size		Size of buf
+	@param len		Length of an existing trace already in buf, to read or append to. If zero, a new trace is started.
+					Nothing is appended to an existing trace without a valid header (see IsValid()).
+ */
+CLITrace::CLITrace(uint8_t* buf, size_t size, size_t len)
+	: m_buf(buf)
+	, m_size(size)
+	, m_len(len)
+	, m_readOffset(HEADER_SIZE)
+	, m_lastTime(0)
+	, m_dropped(0)
+	, m_started(false)
+	, m_writable(false)
+{
+	if(len == 0)
+		Clear();
+	else
+		m_writable = IsValid();
+}
+
+/**
+	@brief Discards everything recorded and starts a new trace
+ */
+void CLITrace::Clear()
+{
+	m_len = 0;
+	m_readOffset = HEADER_SIZE;
+	m_dropped = 0;
+	m_lastTime = 0;
+	m_started = false;
+
+	m_writable = (m_size >= HEADER_SIZE);
+	if(!m_writable)
+		return;
+	for(size_t i=0; i<HEADER_SIZE; i++)
+		m_buf[m_len++] = g_traceHeader[i];
+}
+
+/**
+	@brief Records a block of input bytes which all arrived at the same time
+
+	@param data			The input
+	@param len			Length of data
+	@param timestamp	Arrival time in microseconds (see CLISessionContext::GetTimestamp())
+ */
+void CLITrace::Record(const char* data, size_t len, uint32_t timestamp)
+{
+	if(len == 0)
+		return;
+
+	//First byte recorded (even if appending to an existing trace) starts the clock
+	uint32_t delta = m_started ? timestamp - m_lastTime : 0;
+	m_lastTime = timestamp;
+	m_started = true;
+
+	for(size_t i=0; i<len; i++)
+	{
+		//Make sure the whole record fits before writing any of it
+		size_t recordLen = 2;
+		for(uint32_t d = delta; d >= 0x80; d >>= 7)
+			recordLen ++;
+		if(!m_writable || (m_len + recordLen > m_size) )
+		{
+			m_dropped += len - i;
+			return;
+		}
+
+		for(; delta >= 0x80; delta >>= 7)
+			m_buf[m_len++] = 0x80 | (delta & 0x7f);
+		m_buf[m_len++] = delta;
+		m_buf[m_len++] = data[i];
+
+		//Remaining bytes arrived with this one
+		delta = 0;
+	}
+}
+
+/**
+	@brief Returns true if the trace has a valid header for this version of the format
+ */
+bool CLITrace::IsValid() const
+{
+	if(m_len < HEADER_SIZE)
+		return false;
+	for(size_t i=0; i<HEADER_SIZE; i++)
+	{
+		if(m_buf[i] != g_traceHeader[i])
+			return false;
+	}
+	return true;
+}
+
+/**
+	@brief Goes back to the first record, for Read()
+ */
+void CLITrace::Rewind()
+{
+	m_readOffset = HEADER_SIZE;
+}
+
+/**
+	@brief Reads the next record
+
+	@param c		The input byte
+	@param delta	Time since the previous input byte, in microseconds
+
+	@return False at the end of the trace, or if the last record is truncated
+ */
+bool CLITrace::Read(char& c, uint32_t& delta)
+{
+	delta = 0;
+	for(int shift = 0; m_readOffset < m_len; shift += 7)
+	{
+		uint8_t b = m_buf[m_readOffset++];
+		if(shift < 32)
+			delta |= static_cast<uint32_t>(b & 0x7f) << shift;
+		if(!(b & 0x80))
+		{
+			if(m_readOffset >= m_len)
+				return false;
+			c = m_buf[m_readOffset++];
+			return true;
+		}
+	}
+	return false;
+}
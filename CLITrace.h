@@ -0,0 +1,121 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLITrace
+ */
+#ifndef CLITrace_h
+#define CLITrace_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+	@brief A recording of the input to a session, with arrival times, which can be replayed later
+
+	The format is a four byte header ("CLT" and a version number, currently 1), followed by one record per input byte:
+	the time since the previous byte in microseconds as an unsigned LEB128 varint, then the byte itself. Typed
+	characters take three or four bytes each, pasted or batched input two.
+
+	Recording stops when the buffer is full; later input is counted but not recorded.
+ */
+class CLITrace
+{
+public:
+	CLITrace(uint8_t* buf, size_t size, size_t len = 0);
+
+	void Clear();
+	void Record(const char* data, size_t len, uint32_t timestamp);
+
+	bool IsValid() const;
+	void Rewind();
+	bool Read(char& c, uint32_t& delta);
+
+	///@brief Returns the trace data (including the header)
+	const uint8_t* GetData() const
+	{ return m_buf; }
+
+	///@brief Returns the length of the trace data, in bytes
+	size_t GetLength() const
+	{ return m_len; }
+
+	///@brief Returns the number of input bytes which didn't fit in the trace
+	size_t GetDroppedCount() const
+	{ return m_dropped; }
+
+	///@brief Size of the trace header
+	static const size_t HEADER_SIZE = 4;
+
+protected:
+
+	///@brief Trace storage
+	uint8_t* m_buf;
+
+	///@brief Size of m_buf
+	size_t m_size;
+
+	///@brief Number of bytes of m_buf in use
+	size_t m_len;
+
+	///@brief Offset of the next record to read
+	size_t m_readOffset;
+
+	///@brief Timestamp of the last byte recorded
+	uint32_t m_lastTime;
+
+	///@brief Number of input bytes dropped because the buffer was full
+	size_t m_dropped;
+
+	///@brief True once a byte has been recorded, so later ones are timed from m_lastTime
+	bool m_started;
+
+	///@brief True if records can be added (there's room for the header, and any existing trace has a valid one)
+	bool m_writable;
+};
+
+/**
+	@brief A CLITrace with statically allocated storage
+
+	@tparam SIZE	Size of the trace buffer, in bytes
+ */
+template<size_t SIZE>
+class CLITraceStorage : public CLITrace
+{
+public:
+	CLITraceStorage()
+	: CLITrace(m_storage, SIZE)
+	{}
+
+protected:
+	uint8_t m_storage[SIZE];
+};
+
+#endif
@@ -0,0 +1,155 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CLITreeNode
+ */
+#ifndef CLITreeNode_h
+#define CLITreeNode_h
+
+#include <stddef.h>
+#include "CLIKeyword.h"
+#include "CLIPackedTree.h"
+
+/**
+	@brief A keyword in a command tree, which may be either clikeyword_t tables or a packed tree
+
+	This is what the session walks the tree with, so both formats can be parsed, completed, and listed in help by the
+	same code. It's small and meant to be passed by value.
+
+	A null node stands for the end of a level, or a keyword with no children.
+ */
+class CLITreeNode
+{
+public:
+
+	///@brief Creates a null node
+	CLITreeNode()
+	: m_row(NULL)
+	, m_tree(NULL)
+	{}
+
+	///@brief Refers to the first keyword in a clikeyword_t array (null if the array is null or empty)
+	CLITreeNode(const clikeyword_t* row)
+	: m_row( ( (row != NULL) && (row->keyword != NULL) ) ? row : NULL)
+	, m_tree(NULL)
+	{}
+
+	///@brief Refers to the first keyword in the top level of a packed tree
+	CLITreeNode(const clipackedtree_t* tree)
+	: m_node( (tree != NULL) ? tree->nodes : NULL)
+	, m_tree(tree)
+	{}
+
+	///@brief Returns true if this doesn't refer to a keyword
+	bool IsNull() const
+	{ return IsPacked() ? (m_node == NULL) : (m_row == NULL); }
+
+	///@brief Returns true if this is part of a packed tree
+	bool IsPacked() const
+	{ return m_tree != NULL; }
+
+	///@brief Returns the keyword
+	const char* GetKeyword() const
+	{ return IsPacked() ? m_tree->strings + (m_node->keyword & ~CLI_PACKED_LAST) : m_row->keyword; }
+
+	///@brief Returns the command ID
+	uint16_t GetID() const
+	{ return IsPacked() ? m_node->id : m_row->id; }
+
+	///@brief Returns the help text
+	const char* GetHelp() const
+	{ return IsPacked() ? m_tree->strings + m_node->help : m_row->help; }
+
+	///@brief Returns the handler index
+	uint16_t GetHandler() const
+	{ return IsPacked() ? m_node->handler : m_row->handler; }
+
+	///@brief Returns the first keyword which can follow this one (null if none)
+	CLITreeNode GetChildren() const
+	{
+		if(!IsPacked())
+			return CLITreeNode(m_row->children);
+		if(m_node->children == CLI_PACKED_NONE)
+			return CLITreeNode(NULL, m_tree);
+		return CLITreeNode(m_tree->nodes + m_node->children, m_tree);
+	}
+
+	///@brief Returns the next keyword at the same level (null after the last one)
+	CLITreeNode GetNext() const
+	{
+		if(IsPacked())
+			return CLITreeNode( (m_node->keyword & CLI_PACKED_LAST) ? NULL : m_node + 1, m_tree);
+		return CLITreeNode(m_row + 1);
+	}
+
+	///@brief Returns the keyword i rows after this one, at the same level (which must exist)
+	CLITreeNode operator+(uint16_t i) const
+	{
+		if(IsPacked())
+			return CLITreeNode(m_node + i, m_tree);
+		return CLITreeNode(m_row + i);
+	}
+
+	///@brief Returns the clikeyword_t this refers to, or null for packed trees
+	const clikeyword_t* GetRow() const
+	{ return IsPacked() ? NULL : m_row; }
+
+	bool operator==(const CLITreeNode& rhs) const
+	{
+		if(m_tree != rhs.m_tree)
+			return false;
+		return IsPacked() ? (m_node == rhs.m_node) : (m_row == rhs.m_row);
+	}
+
+	bool operator!=(const CLITreeNode& rhs) const
+	{ return !(*this == rhs); }
+
+protected:
+	CLITreeNode(const clipackednode_t* node, const clipackedtree_t* tree)
+	: m_node(node)
+	, m_tree(tree)
+	{}
+
+	union
+	{
+		///@brief The keyword, for clikeyword_t trees
+		const clikeyword_t* m_row;
+
+		///@brief The keyword, for packed trees
+		const clipackednode_t* m_node;
+	};
+
+	///@brief The tree, if it's packed, or null for clikeyword_t trees
+	const clipackedtree_t* m_tree;
+};
+
+#endif
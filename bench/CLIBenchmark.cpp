@@ -0,0 +1,497 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Host-side micro-benchmarks for the parser, line editor, and output paths
+
+	Everything is written to a CountingOutputStream, so the numbers reflect CPU time spent in the library plus the
+	number of bytes that would have been sent to a real transport.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <CLISessionContext.h>
+#include <CLIKeywordIndex.h>
+#include "CountingOutputStream.h"
+#include "ThrottledOutputStream.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Synthetic command trees
+
+///@brief Largest number of top level keywords we benchmark
+#define MAX_BENCH_KEYWORDS 256
+
+///@brief Number of keywords in the second level of the tree (shared by all top level keywords)
+#define BENCH_CHILD_KEYWORDS 16
+
+static char g_rootNames[MAX_BENCH_KEYWORDS][12];
+static char g_childNames[BENCH_CHILD_KEYWORDS][12];
+static clikeyword_t g_rootCommands[MAX_BENCH_KEYWORDS + 1];
+static clikeyword_t g_childCommands[BENCH_CHILD_KEYWORDS + 1];
+
+static CLIKeywordIndexStorage<4, MAX_BENCH_KEYWORDS + BENCH_CHILD_KEYWORDS, 4096> g_index;
+
+/**
+	@brief Makes a pseudo-random keyword
+
+	Keywords are drawn from a small alphabet so that many of them share prefixes, like real command trees do.
+ */
+static void MakeKeyword(char* name, unsigned int seed)
+{
+	static const char alphabet[] = "aceinorst";
+	unsigned int x = seed * 2654435761u + 12345;
+	for(int i=0; i<8; i++)
+	{
+		name[i] = alphabet[(x >> 8) % 9];
+		x = x * 1103515245u + 12345;
+	}
+	name[8] = '\0';
+}
+
+/**
+	@brief Builds a command tree with the specified number of top level keywords, each having the same children
+ */
+static void MakeTree(int width)
+{
+	for(int i=0; i<BENCH_CHILD_KEYWORDS; i++)
+	{
+		MakeKeyword(g_childNames[i], 1000 + i);
+		g_childCommands[i] = { g_childNames[i], (uint16_t)i, NULL, "Child keyword" };
+	}
+	g_childCommands[BENCH_CHILD_KEYWORDS] = { NULL, INVALID_COMMAND, NULL, NULL };
+
+	for(int i=0; i<width; i++)
+	{
+		MakeKeyword(g_rootNames[i], i);
+		g_rootCommands[i] = { g_rootNames[i], (uint16_t)i, g_childCommands, "Top level keyword" };
+	}
+	g_rootCommands[width] = { NULL, INVALID_COMMAND, NULL, NULL };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Session wrapper
+
+/**
+	@brief Session which exposes the internals we want to time
+ */
+class BenchSession : public CLISessionContextStorage<>
+{
+public:
+	BenchSession(const clikeyword_t* root, const CLIKeywordIndex* index)
+	: CLISessionContextStorage(root, index)
+	{}
+
+	virtual void PrintPrompt() override
+	{ m_output->PutString("> "); }
+
+	virtual void OnExecute() override
+	{}
+
+	virtual uint32_t GetTimestamp() override
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	///@brief Types a string without executing it
+	void Type(const char* str, bool echo = true)
+	{
+		for(; *str; str++)
+			OnKeystroke(*str, echo);
+	}
+
+	///@brief Canonicalizes the current line for parsing
+	void PrepareToParse()
+	{ OnLineReady(); }
+
+	bool Parse()
+	{ return ParseCommand(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Timing helpers
+
+/**
+	@brief Runs a function the specified number of times and returns the average time per call, in ns
+ */
+template<class T>
+static double TimeNs(size_t iterations, T func)
+{
+	auto start = std::chrono::steady_clock::now();
+	for(size_t i=0; i<iterations; i++)
+		func();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+///@brief Sends the keystrokes for a left arrow
+static void ArrowLeft(BenchSession& session)
+{
+	session.OnKeystroke('\x1b');
+	session.OnKeystroke('[');
+	session.OnKeystroke('D');
+}
+
+///@brief Sends the keystrokes for a right arrow
+static void ArrowRight(BenchSession& session)
+{
+	session.OnKeystroke('\x1b');
+	session.OnKeystroke('[');
+	session.OnKeystroke('C');
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+
+/**
+	@brief Time to parse a complete two-word command, with and without an index, at various tree widths
+ */
+static void BenchParse()
+{
+	static const int widths[] = { 4, 16, 64, 256 };
+
+	printf("ParseCommand (ns per call)\n");
+	printf("    %-8s %12s %12s\n", "width", "linear", "indexed");
+	for(int width : widths)
+	{
+		MakeTree(width);
+		g_index.Build(g_rootCommands);
+
+		//Pick a keyword from the end of the table, since that's the worst case for a linear search
+		char line[32];
+		snprintf(line, sizeof(line), "%s %s", g_rootNames[width-1], g_childNames[BENCH_CHILD_KEYWORDS-1]);
+
+		double ns[2];
+		for(int indexed = 0; indexed < 2; indexed++)
+		{
+			CountingOutputStream stream;
+			BenchSession session(g_rootCommands, indexed ? &g_index : NULL);
+			session.Initialize(&stream, "bench");
+			session.Type(line);
+			session.PrepareToParse();
+
+			ns[indexed] = TimeNs(100000, [&]{ session.Parse(); });
+		}
+
+		printf("    %-8d %12.1f %12.1f\n", width, ns[0], ns[1]);
+	}
+	printf("\n");
+}
+
+/**
+	@brief Time and output bytes for editing keystrokes at various positions in a long line
+ */
+static void BenchKeystrokes(uint8_t caps, const char* terminal)
+{
+	MakeTree(16);
+
+	//Seven tokens of seven characters, 55 columns total
+	static const char* line = "abcdefg abcdefg abcdefg abcdefg abcdefg abcdefg abcdefg";
+	static const int offsets[] = { 0, 27, 55 };
+
+	printf("OnKeystroke, %s terminal (time and output per editing operation)\n", terminal);
+	printf("    %-12s %8s %10s %10s %12s\n", "operation", "column", "ns/op", "bytes/op", "flushes/op");
+	for(int col : offsets)
+	{
+		CountingOutputStream stream;
+		BenchSession session(g_rootCommands, NULL);
+		session.Initialize(&stream, "bench");
+		session.SetTerminalCapabilities(caps);
+		session.Type(line);
+		for(int i=55; i>col; i--)
+			ArrowLeft(session);
+
+		//Insert a character then delete it again, so the line is the same after each iteration.
+		//Time is averaged over both.
+		stream.Reset();
+		session.OnKeystroke('x');
+		size_t insertBytes = stream.m_bytes;
+		stream.Reset();
+		session.OnKeystroke('\x7f');
+		size_t backspaceBytes = stream.m_bytes;
+		const size_t iterations = 100000;
+		size_t flushes = stream.m_flushes;
+		double ns = TimeNs(iterations, [&]{ session.OnKeystroke('x'); session.OnKeystroke('\x7f'); }) / 2;
+		double flushesPerOp = (stream.m_flushes - flushes) / (2.0 * iterations);
+		printf("    %-12s %8d %10.1f %10zu %12.1f\n", "insert", col, ns, insertBytes, flushesPerOp);
+		printf("    %-12s %8d %10.1f %10zu %12.1f\n", "backspace", col + 1, ns, backspaceBytes, flushesPerOp);
+
+		//Move left and back right again. Can't go left from the start of the line, so go right then left there.
+		stream.Reset();
+		ns = TimeNs(iterations, [&]
+		{
+			if(col == 0)
+			{
+				ArrowRight(session);
+				ArrowLeft(session);
+			}
+			else
+			{
+				ArrowLeft(session);
+				ArrowRight(session);
+			}
+		}) / 2;
+		printf("    %-12s %8d %10.1f %10.1f %12.1f\n",
+			"arrow",
+			col,
+			ns,
+			stream.m_bytes / (2.0 * iterations),
+			stream.m_flushes / (2.0 * iterations));
+	}
+	printf("\n");
+}
+
+/**
+	@brief Bytes emitted by a full line redraw and by help output
+ */
+static void BenchOutput()
+{
+	static const int widths[] = { 4, 16, 64, 256 };
+
+	printf("Help output ('?' on an empty line)\n");
+	printf("    %-8s %12s %12s\n", "width", "ns", "bytes");
+	for(int width : widths)
+	{
+		MakeTree(width);
+
+		CountingOutputStream stream;
+		BenchSession session(g_rootCommands, NULL);
+		session.Initialize(&stream, "bench");
+
+		session.OnKeystroke('?');
+		size_t bytes = stream.m_bytes;
+		double ns = TimeNs(1000, [&]{ session.OnKeystroke('?'); });
+
+		printf("    %-8d %12.1f %12zu\n", width, ns, bytes);
+	}
+	printf("\n");
+
+	//With a known terminal height, only the first page is sent until the user asks for more
+	CountingOutputStream pagedStream;
+	BenchSession paged(g_rootCommands, NULL);
+	paged.Initialize(&pagedStream, "bench");
+	paged.SetTerminalRows(24);
+	pagedStream.Reset();
+	paged.OnKeystroke('?');
+	printf("Help output, first page on a 24 row terminal (width %d)\n", widths[3]);
+	printf("    %zu bytes\n\n", pagedStream.m_bytes);
+
+	//Typing a whole line at the start of an existing one redraws everything to the right each time
+	MakeTree(16);
+	CountingOutputStream stream;
+	BenchSession session(g_rootCommands, NULL);
+	session.Initialize(&stream, "bench");
+	session.Type("abcdefg abcdefg abcdefg");
+	for(int i=0; i<23; i++)
+		ArrowLeft(session);
+	stream.Reset();
+	session.Type("abcdefg abcdefg abcdefg ");
+	printf("Redraw (typing 24 characters at the start of a 23 character line)\n");
+	printf("    %zu bytes, %.1f bytes per keystroke\n\n", stream.m_bytes, stream.m_bytes / 24.0);
+}
+
+/**
+	@brief Time and flushes for a multi-line paste, one keystroke at a time vs all at once, and as a bracketed paste
+ */
+static void BenchBatch()
+{
+	MakeTree(16);
+
+	static const char paste[] =
+		"abcdefg abcdefg abcdefg abcdefg\n"
+		"abcdefghijklmnopqrst abcdefg\n"
+		"abcdefg abcdefg abcdefg abcdefg abcdefg abcdefg\n";
+	const size_t len = sizeof(paste) - 1;
+	static const char pasteStart[] = "\x1b[200~";
+	static const char pasteEnd[] = "\x1b[201~";
+
+	printf("Paste of %zu bytes\n", len);
+	printf("    %-12s %10s %10s %10s\n", "api", "ns/byte", "bytes", "flushes");
+	static const char* const names[] = {"OnKeystroke", "OnKeystrokes", "bracketed"};
+	for(int mode = 0; mode < 3; mode++)
+	{
+		CountingOutputStream stream;
+		BenchSession session(g_rootCommands, NULL);
+		session.Initialize(&stream, "bench");
+
+		const size_t iterations = 10000;
+		double ns = TimeNs(iterations, [&]
+		{
+			if(mode == 0)
+			{
+				for(size_t i=0; i<len; i++)
+					session.OnKeystroke(paste[i]);
+			}
+			else if(mode == 1)
+				session.OnKeystrokes(paste, len);
+			else
+			{
+				session.OnKeystrokes(pasteStart, sizeof(pasteStart) - 1);
+				session.OnKeystrokes(paste, len);
+				session.OnKeystrokes(pasteEnd, sizeof(pasteEnd) - 1);
+			}
+		});
+
+		printf("    %-12s %10.1f %10zu %10zu\n",
+			names[mode],
+			ns / len,
+			stream.m_bytes / iterations,
+			stream.m_flushes / iterations);
+	}
+	printf("\n");
+}
+
+/**
+	@brief Pastes a large script into a session over a slow transport, with and without honoring backpressure
+ */
+static void BenchBackpressure()
+{
+	MakeTree(16);
+
+	static const char line[] = "abcdefg abcdefg abcdefg abcdefg abcdefg abcdefg\n";
+	static char paste[sizeof(line) * 40];
+	size_t len = 0;
+	for(int i=0; i<40; i++)
+	{
+		memcpy(paste + len, line, sizeof(line) - 1);
+		len += sizeof(line) - 1;
+	}
+
+	printf("Paste of %zu bytes through a 256 byte buffer draining 32 bytes per tick\n", len);
+	printf("    %-12s %10s %10s %10s\n", "caller", "ticks", "sent", "dropped");
+	for(int throttled = 0; throttled < 2; throttled++)
+	{
+		ThrottledOutputStream<256> stream(32);
+		BenchSession session(g_rootCommands, NULL);
+		session.Initialize(&stream, "bench");
+
+		//Each tick, offer everything not yet consumed, then let the transport drain
+		size_t ticks = 0;
+		size_t offset = 0;
+		while( (offset < len) || (stream.GetPending() > 0) )
+		{
+			if(throttled)
+				offset += session.OnKeystrokes(paste + offset, len - offset);
+			else
+			{
+				for(; offset < len; offset++)
+					session.OnKeystroke(paste[offset]);
+			}
+			stream.Tick();
+			ticks ++;
+		}
+
+		printf("    %-12s %10zu %10zu %10zu\n",
+			throttled ? "paused" : "ignores",
+			ticks,
+			stream.m_sent,
+			stream.GetDroppedCount());
+	}
+	printf("\n");
+}
+
+/**
+	@brief Replays a boot-time configuration through the keystroke path and through ExecuteScript()
+ */
+static void BenchScript()
+{
+	MakeTree(64);
+
+	//A few hundred lines of two keyword commands, which all parse
+	static char script[512 * 20];
+	size_t len = 0;
+	const int nlines = 500;
+	for(int i=0; i<nlines; i++)
+	{
+		len += snprintf(script + len, sizeof(script) - len, "%s %s\n",
+			g_rootNames[(i * 7) % 64],
+			g_childNames[i % BENCH_CHILD_KEYWORDS]);
+	}
+
+	printf("Replay of a %d line script (%zu bytes)\n", nlines, len);
+	printf("    %-14s %12s %12s\n", "api", "us", "lines/s");
+
+	CountingOutputStream stream;
+	BenchSession session(g_rootCommands, NULL);
+	session.Initialize(&stream, "bench");
+
+	double ns = TimeNs(20, [&]
+	{
+		for(size_t i=0; i<len; i++)
+			session.OnKeystroke(script[i], false);
+	});
+	printf("    %-14s %12.1f %12.0f\n", "OnKeystroke", ns / 1000, nlines * 1e9 / ns);
+
+	ns = TimeNs(20, [&]{ session.OnKeystrokes(script, len, false); });
+	printf("    %-14s %12.1f %12.0f\n", "OnKeystrokes", ns / 1000, nlines * 1e9 / ns);
+
+	cliscriptstats_t stats;
+	ns = TimeNs(20, [&]{ session.ExecuteScript(script, len, &stats); });
+	printf("    %-14s %12.1f %12.0f\n", "ExecuteScript", ns / 1000, nlines * 1e9 / ns);
+	printf("    (last run: %u lines, %u failures, %u us)\n", stats.lines, stats.failures, stats.elapsed);
+
+	//Same commands as pre-resolved binary frames
+	static uint8_t frames[nlines][4];
+	for(int i=0; i<nlines; i++)
+	{
+		uint16_t root = g_rootCommands[(i * 7) % 64].id;
+		uint16_t child = g_childCommands[i % BENCH_CHILD_KEYWORDS].id;
+		frames[i][0] = root & 0xff;
+		frames[i][1] = root >> 8;
+		frames[i][2] = child & 0xff;
+		frames[i][3] = child >> 8;
+	}
+	int failures = 0;
+	ns = TimeNs(20, [&]
+	{
+		for(int i=0; i<nlines; i++)
+		{
+			if(!session.ExecuteFrame(frames[i], sizeof(frames[i])))
+				failures ++;
+		}
+	});
+	printf("    %-14s %12.1f %12.0f\n", "ExecuteFrame", ns / 1000, nlines * 1e9 / ns);
+	if(failures)
+		printf("    (%d frames failed)\n", failures);
+	printf("\n");
+}
+
+int main()
+{
+	BenchParse();
+	BenchKeystrokes(0, "VT100");
+	BenchKeystrokes(CLISessionContext::TERM_CAP_INSERT_DELETE, "VT102");
+	BenchBatch();
+	BenchBackpressure();
+	BenchScript();
+	BenchOutput();
+	return 0;
+}
@@ -0,0 +1,279 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+/**
+	@file
+	@brief Converts a clikeyword_t command tree to a packed tree (see CLIPackedTree.h)
+
+	Usage: cli-packtree [-n name] output
+
+		-n	Name of the generated clipackedtree_t (default g_packedCommands)
+
+	The tree converted is g_replayCommands, from the same EMBEDDED_CLI_REPLAY_COMMANDS source file as cli-replay. The
+	output is a C++ source file to be compiled into the firmware in place of the clikeyword_t tables.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <CLIKeyword.h>
+#include <CLIPackedTree.h>
+
+extern const clikeyword_t g_replayCommands[];
+
+///@brief Size of a clikeyword_t on a 32-bit target, for comparison
+static const size_t TARGET_KEYWORD_SIZE = 20;
+
+/**
+	@brief Builds the node array and string pool for a tree
+ */
+class TreePacker
+{
+public:
+	bool Pack(const clikeyword_t* root);
+
+	///@brief The nodes, in the order they'll be output
+	std::vector<clipackednode_t> m_nodes;
+
+	///@brief Keyword for each node, for comments in the output
+	std::vector<const char*> m_keywords;
+
+	///@brief The string pool
+	std::string m_strings;
+
+	///@brief Number of clikeyword_t rows in the original tree, including terminators
+	size_t m_rows = 0;
+
+	///@brief Bytes of distinct string literals in the original tree
+	size_t m_originalStrings = 0;
+
+protected:
+	uint16_t AddString(const char* str);
+	uint16_t GetLevel(const clikeyword_t* level);
+
+	///@brief Offset of each string already in the pool
+	std::map<std::string, uint16_t> m_stringOffsets;
+
+	///@brief String literals already counted in m_originalStrings
+	std::map<const char*, bool> m_seenStrings;
+
+	///@brief Index of the first node of each level already laid out
+	std::map<const clikeyword_t*, uint16_t> m_levels;
+
+	///@brief Levels laid out, but whose children haven't been yet
+	std::vector<const clikeyword_t*> m_pending;
+};
+
+/**
+	@brief Returns the offset of a string in the pool, adding it if it's not there yet
+ */
+uint16_t TreePacker::AddString(const char* str)
+{
+	if(str == nullptr)
+		str = "";
+
+	if(!m_seenStrings[str])
+	{
+		m_seenStrings[str] = true;
+		m_originalStrings += strlen(str) + 1;
+	}
+
+	auto it = m_stringOffsets.find(str);
+	if(it != m_stringOffsets.end())
+		return it->second;
+
+	//Offsets need to leave room for the CLI_PACKED_LAST flag
+	size_t offset = m_strings.size();
+	m_strings.append(str, strlen(str) + 1);
+	if(m_strings.size() > CLI_PACKED_LAST)
+	{
+		fprintf(stderr, "String pool is over %d bytes\n", CLI_PACKED_LAST);
+		exit(1);
+	}
+
+	m_stringOffsets[str] = offset;
+	return offset;
+}
+
+/**
+	@brief Returns the index of the first node of a level, laying it out after everything else if it's new
+
+	@return Node index, or CLI_PACKED_NONE if the level is empty
+ */
+uint16_t TreePacker::GetLevel(const clikeyword_t* level)
+{
+	if( (level == nullptr) || (level->keyword == nullptr) )
+		return CLI_PACKED_NONE;
+
+	auto it = m_levels.find(level);
+	if(it != m_levels.end())
+		return it->second;
+
+	size_t first = m_nodes.size();
+	for(auto row = level; row->keyword != nullptr; row++)
+	{
+		m_nodes.push_back({AddString(row->keyword), row->id, CLI_PACKED_NONE, AddString(row->help), row->handler});
+		m_keywords.push_back(row->keyword);
+		m_rows ++;
+	}
+	m_nodes.back().keyword |= CLI_PACKED_LAST;
+	m_rows ++;
+
+	if(m_nodes.size() >= CLI_PACKED_NONE)
+	{
+		fprintf(stderr, "Tree has too many keywords\n");
+		exit(1);
+	}
+
+	m_levels[level] = first;
+	m_pending.push_back(level);
+	return first;
+}
+
+/**
+	@brief Lays out the whole tree, breadth first, so each level's rows are contiguous
+ */
+bool TreePacker::Pack(const clikeyword_t* root)
+{
+	if(GetLevel(root) == CLI_PACKED_NONE)
+		return false;
+
+	for(size_t i=0; i<m_pending.size(); i++)
+	{
+		auto level = m_pending[i];
+		uint16_t first = m_levels[level];
+		for(uint16_t row = 0; level[row].keyword != nullptr; row++)
+		{
+			uint16_t children = GetLevel(level[row].children);
+			m_nodes[first + row].children = children;
+		}
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Output
+
+///@brief Writes a string with anything unusual escaped
+static void PrintEscaped(FILE* fp, const char* str)
+{
+	for(; *str; str++)
+	{
+		char c = *str;
+		if( (c == '"') || (c == '\\') )
+			fprintf(fp, "\\%c", c);
+		else if( (c >= ' ') && (c < '\x7f') )
+			fputc(c, fp);
+		else
+			fprintf(fp, "\\%03o", static_cast<uint8_t>(c));
+	}
+}
+
+static void WriteTree(FILE* fp, const TreePacker& packer, const char* name)
+{
+	fprintf(fp, "//Generated by cli-packtree. Do not edit.\n\n");
+	fprintf(fp, "#include <CLIPackedTree.h>\n\n");
+
+	//One line per string, so the pool can be read
+	fprintf(fp, "static const char g_packedStrings[] =\n");
+	const auto& strings = packer.m_strings;
+	for(size_t offset = 0; offset < strings.size(); offset += strlen(strings.c_str() + offset) + 1)
+	{
+		fprintf(fp, "\t/* %5zu */ \"", offset);
+		PrintEscaped(fp, strings.c_str() + offset);
+		fprintf(fp, "\\0\"\n");
+	}
+	fprintf(fp, "\t;\n\n");
+
+	fprintf(fp, "static const clipackednode_t g_packedNodes[] =\n{\n");
+	for(size_t i=0; i<packer.m_nodes.size(); i++)
+	{
+		auto& node = packer.m_nodes[i];
+		fprintf(fp, "\t/* %5zu */ {0x%04x, 0x%04x, 0x%04x, 0x%04x, %u},\t// ",
+			i, node.keyword, node.id, node.children, node.help, node.handler);
+		PrintEscaped(fp, packer.m_keywords[i]);
+		fprintf(fp, "\n");
+	}
+	fprintf(fp, "};\n\n");
+
+	fprintf(fp, "extern const clipackedtree_t %s;\n", name);
+	fprintf(fp, "const clipackedtree_t %s = {g_packedNodes, g_packedStrings};\n", name);
+}
+
+static void Usage()
+{
+	fprintf(stderr, "Usage: cli-packtree [-n name] output\n");
+	exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* name = "g_packedCommands";
+	const char* outputPath = nullptr;
+
+	for(int i=1; i<argc; i++)
+	{
+		const char* arg = argv[i];
+		if(!strcmp(arg, "-n") && (i + 1 < argc) )
+			name = argv[++i];
+		else if( (arg[0] != '-') && (outputPath == nullptr) )
+			outputPath = arg;
+		else
+			Usage();
+	}
+	if(outputPath == nullptr)
+		Usage();
+
+	TreePacker packer;
+	if(!packer.Pack(g_replayCommands))
+	{
+		fprintf(stderr, "Command tree is empty\n");
+		return 1;
+	}
+
+	FILE* fp = fopen(outputPath, "w");
+	if(!fp)
+	{
+		perror(outputPath);
+		return 1;
+	}
+	WriteTree(fp, packer, name);
+	fclose(fp);
+
+	size_t originalSize = packer.m_rows * TARGET_KEYWORD_SIZE + packer.m_originalStrings;
+	size_t packedSize = packer.m_nodes.size() * sizeof(clipackednode_t) + packer.m_strings.size();
+	fprintf(stderr, "clikeyword_t tables: %5zu rows   x %2zu + %5zu bytes of strings = %6zu bytes\n",
+		packer.m_rows, TARGET_KEYWORD_SIZE, packer.m_originalStrings, originalSize);
+	fprintf(stderr, "Packed tree:         %5zu nodes  x %2zu + %5zu bytes of strings = %6zu bytes\n",
+		packer.m_nodes.size(), sizeof(clipackednode_t), packer.m_strings.size(), packedSize);
+	return 0;
+}
@@ -0,0 +1,364 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Replays a keystroke trace recorded with CLISessionContext::SetTrace(), and reports what it cost
+
+	Usage: cli-replay [-b] [-i] [-x] [-r rows] [-n passes] [-o transcript] [-c csv] trace
+
+		-b	Feed bytes which arrived together to OnKeystrokes() in one call, rather than one at a time
+		-i	Use a CLIKeywordIndex
+		-x	Terminal supports insert/delete character (VT102 and later)
+		-r	Terminal height, for paging help
+		-n	Number of times to replay the trace. Each keystroke is reported at its fastest. (default 5)
+		-o	Write everything the session output to this file
+		-c	Write a line per keystroke (index, time, byte, ns, output bytes) to this CSV file
+
+	The session sees the trace's timestamps from GetTimestamp(), so replays are deterministic.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <CLISessionContext.h>
+#include <CLIKeywordIndex.h>
+#include <CLIOutputStream.h>
+#include <CLITrace.h>
+
+extern const clikeyword_t g_replayCommands[];
+
+static CLIKeywordIndexStorage<256, 2048, 16384> g_index;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Session and output
+
+/**
+	@brief An output stream which keeps everything written to it
+ */
+class CaptureOutputStream : public CLIOutputStream
+{
+public:
+	virtual void PutCharacter(char ch) override
+	{ m_data += ch; }
+
+	virtual void PutString(const char* str) override
+	{ m_data += str; }
+
+	virtual void PutData(const char* data, size_t len) override
+	{ m_data.append(data, len); }
+
+	virtual void Flush() override
+	{}
+
+	///@brief Everything output so far
+	std::string m_data;
+};
+
+/**
+	@brief Session which runs on trace time
+ */
+class ReplaySession : public CLISessionContextStorage<>
+{
+public:
+	ReplaySession(const CLIKeywordIndex* index)
+	: CLISessionContextStorage(g_replayCommands, index)
+	, m_now(0)
+	{}
+
+	virtual void PrintPrompt() override
+	{ m_output->PutString("> "); }
+
+	///@brief Commands do nothing, only the cost of the line editor and parser is of interest
+	virtual void OnExecute() override
+	{}
+
+	virtual uint32_t GetTimestamp() override
+	{ return m_now; }
+
+	///@brief Current trace time, in microseconds
+	uint32_t m_now;
+};
+
+/**
+	@brief One call into the session: a single keystroke, or a batch that arrived together
+ */
+struct replaystep_t
+{
+	///@brief Offset of the first byte in the input
+	size_t offset;
+
+	///@brief Number of bytes
+	size_t len;
+
+	///@brief Trace time, in microseconds since the first byte
+	uint32_t time;
+
+	///@brief Fastest time taken by the session, in ns
+	double ns;
+
+	///@brief Number of bytes output
+	size_t bytes;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Replay
+
+/**
+	@brief Replays the input once, timing each step
+
+	@return Everything the session output
+ */
+static std::string Replay(
+	const std::string& input,
+	std::vector<replaystep_t>& steps,
+	const CLIKeywordIndex* index,
+	uint8_t caps,
+	uint16_t rows,
+	bool first)
+{
+	CaptureOutputStream stream;
+	ReplaySession session(index);
+	session.Initialize(&stream, "");
+	session.SetTerminalCapabilities(caps);
+	session.SetTerminalRows(rows);
+	session.PrintPrompt();
+
+	for(auto& step : steps)
+	{
+		session.m_now = step.time;
+		size_t before = stream.m_data.size();
+
+		auto start = std::chrono::steady_clock::now();
+		if(step.len == 1)
+			session.OnKeystroke(input[step.offset]);
+		else
+			session.OnKeystrokes(input.data() + step.offset, step.len);
+		auto end = std::chrono::steady_clock::now();
+
+		double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		if(first || (ns < step.ns) )
+			step.ns = ns;
+		step.bytes = stream.m_data.size() - before;
+	}
+
+	return stream.m_data;
+}
+
+///@brief Formats an input byte for display
+static const char* KeyName(char c)
+{
+	static char buf[8];
+	switch(c)
+	{
+		case '\r':		return "CR";
+		case '\n':		return "LF";
+		case '\t':		return "TAB";
+		case '\x1b':	return "ESC";
+		case '\b':		return "BS";
+		case '\x7f':	return "DEL";
+		case ' ':		return "SPACE";
+		default:
+			if( (c > ' ') && (c < '\x7f') )
+				snprintf(buf, sizeof(buf), "%c", c);
+			else
+				snprintf(buf, sizeof(buf), "0x%02x", static_cast<uint8_t>(c));
+			return buf;
+	}
+}
+
+static void Usage()
+{
+	fprintf(stderr, "Usage: cli-replay [-b] [-i] [-x] [-r rows] [-n passes] [-o transcript] [-c csv] trace\n");
+	exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+	bool batch = false;
+	bool useIndex = false;
+	uint8_t caps = 0;
+	uint16_t rows = 0;
+	int passes = 5;
+	const char* transcriptPath = nullptr;
+	const char* csvPath = nullptr;
+	const char* tracePath = nullptr;
+
+	for(int i=1; i<argc; i++)
+	{
+		const char* arg = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if(!strcmp(arg, "-b"))
+			batch = true;
+		else if(!strcmp(arg, "-i"))
+			useIndex = true;
+		else if(!strcmp(arg, "-x"))
+			caps = CLISessionContext::TERM_CAP_INSERT_DELETE;
+		else if(!strcmp(arg, "-r") && hasValue)
+			rows = atoi(argv[++i]);
+		else if(!strcmp(arg, "-n") && hasValue)
+			passes = atoi(argv[++i]);
+		else if(!strcmp(arg, "-o") && hasValue)
+			transcriptPath = argv[++i];
+		else if(!strcmp(arg, "-c") && hasValue)
+			csvPath = argv[++i];
+		else if( (arg[0] != '-') && (tracePath == nullptr) )
+			tracePath = arg;
+		else
+			Usage();
+	}
+	if( (tracePath == nullptr) || (passes < 1) )
+		Usage();
+
+	//Load the trace
+	FILE* fp = fopen(tracePath, "rb");
+	if(!fp)
+	{
+		perror(tracePath);
+		return 1;
+	}
+	std::vector<uint8_t> data;
+	uint8_t buf[4096];
+	size_t n;
+	while( (n = fread(buf, 1, sizeof(buf), fp)) > 0)
+		data.insert(data.end(), buf, buf + n);
+	fclose(fp);
+
+	CLITrace trace(data.data(), data.size(), data.size());
+	if(!trace.IsValid())
+	{
+		fprintf(stderr, "%s: not a trace file (or an unsupported version)\n", tracePath);
+		return 1;
+	}
+
+	//Decode it, splitting into steps
+	std::string input;
+	std::vector<replaystep_t> steps;
+	uint32_t now = 0;
+	char c;
+	uint32_t delta;
+	while(trace.Read(c, delta))
+	{
+		now += delta;
+		if(batch && (delta == 0) && !steps.empty() )
+			steps.back().len ++;
+		else
+			steps.push_back({input.size(), 1, now, 0, 0});
+		input += c;
+	}
+	if(steps.empty())
+	{
+		fprintf(stderr, "%s: trace is empty\n", tracePath);
+		return 1;
+	}
+
+	const CLIKeywordIndex* index = nullptr;
+	if(useIndex)
+	{
+		if(g_index.Build(g_replayCommands))
+			index = &g_index;
+		else
+			fprintf(stderr, "Command tree too big to index, replaying without one\n");
+	}
+
+	std::string transcript;
+	for(int i=0; i<passes; i++)
+		transcript = Replay(input, steps, index, caps, rows, i == 0);
+
+	//Summarize
+	double totalNs = 0;
+	std::vector<double> times;
+	for(auto& step : steps)
+	{
+		totalNs += step.ns;
+		times.push_back(step.ns);
+	}
+	std::sort(times.begin(), times.end());
+
+	printf("Trace:          %zu bytes of input over %.3f s\n", input.size(), steps.back().time * 1e-6);
+	printf("Calls:          %zu\n", steps.size());
+	printf("Output:         %zu bytes (%.1f per input byte)\n", transcript.size(),
+		static_cast<double>(transcript.size()) / input.size());
+	printf("CPU time:       %.1f us total\n", totalNs / 1000);
+	printf("    per call    mean %.0f ns, median %.0f ns, p99 %.0f ns, max %.0f ns\n",
+		totalNs / steps.size(),
+		times[times.size() / 2],
+		times[(times.size() * 99) / 100],
+		times.back());
+
+	//The slowest steps are usually the interesting ones
+	std::vector<size_t> order(steps.size());
+	for(size_t i=0; i<order.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return steps[a].ns > steps[b].ns; });
+	printf("\nSlowest calls:\n");
+	printf("    %8s %12s %8s %10s %8s\n", "index", "time (s)", "key", "ns", "bytes");
+	for(size_t i=0; (i < order.size()) && (i < 10); i++)
+	{
+		auto& step = steps[order[i]];
+		printf("    %8zu %12.6f %8s %10.0f %8zu\n",
+			order[i], step.time * 1e-6, KeyName(input[step.offset]), step.ns, step.bytes);
+	}
+
+	if(transcriptPath)
+	{
+		fp = fopen(transcriptPath, "wb");
+		if(!fp)
+		{
+			perror(transcriptPath);
+			return 1;
+		}
+		fwrite(transcript.data(), 1, transcript.size(), fp);
+		fclose(fp);
+	}
+
+	if(csvPath)
+	{
+		fp = fopen(csvPath, "w");
+		if(!fp)
+		{
+			perror(csvPath);
+			return 1;
+		}
+		fprintf(fp, "index,time_us,byte,len,ns,bytes\n");
+		for(size_t i=0; i<steps.size(); i++)
+		{
+			auto& step = steps[i];
+			fprintf(fp, "%zu,%u,%d,%zu,%.0f,%zu\n",
+				i, step.time, static_cast<uint8_t>(input[step.offset]), step.len, step.ns, step.bytes);
+		}
+		fclose(fp);
+	}
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of CountingOutputStream
+ */
+#ifndef CountingOutputStream_h
+#define CountingOutputStream_h
+
+#include <CLIOutputStream.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+	@brief An output stream which discards everything written to it, but keeps track of how much there was
+ */
+class CountingOutputStream : public CLIOutputStream
+{
+public:
+	CountingOutputStream()
+	{ Reset(); }
+
+	///@brief Zeroes all counters
+	void Reset()
+	{
+		m_bytes = 0;
+		m_flushes = 0;
+	}
+
+	virtual void PutCharacter(char /*ch*/) override
+	{ m_bytes ++; }
+
+	virtual void PutString(const char* str) override
+	{ m_bytes += strlen(str); }
+
+	virtual void PutData(const char* /*data*/, size_t len) override
+	{ m_bytes += len; }
+
+	virtual void Flush() override
+	{ m_flushes ++; }
+
+	///@brief Number of bytes written since the last reset
+	size_t m_bytes;
+
+	///@brief Number of calls to Flush() since the last reset
+	size_t m_flushes;
+};
+
+#endif
@@ -0,0 +1,102 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Example command tree for cli-replay and cli-packtree
+
+	Traces should be replayed against the same command tree as the firmware that recorded them, or help and completion
+	output won't match. Projects can point the EMBEDDED_CLI_REPLAY_COMMANDS CMake variable at a file which defines
+	g_replayCommands for their own tree, which is also the tree cli-packtree converts.
+ */
+#include <CLIKeyword.h>
+#include <CLIToken.h>
+
+enum
+{
+	CMD_ADDRESS = 1,
+	CMD_COUNTERS,
+	CMD_HOSTNAME,
+	CMD_INTERFACE,
+	CMD_IP,
+	CMD_NAME,
+	CMD_NO,
+	CMD_RELOAD,
+	CMD_SET,
+	CMD_SHOW,
+	CMD_STATUS,
+	CMD_VERSION
+};
+
+static const clikeyword_t g_nameArgument[] =
+{
+	{"<name>",		FREEFORM_TOKEN,		nullptr,			"Name"},
+	{nullptr,		INVALID_COMMAND,	nullptr,			nullptr}
+};
+
+static const clikeyword_t g_interfaceCommands[] =
+{
+	{"<cr>",		OPTIONAL_TOKEN,		nullptr,			""},
+	{"counters",	CMD_COUNTERS,		nullptr,			"Packet and error counters"},
+	{"status",		CMD_STATUS,			nullptr,			"Link state"},
+	{nullptr,		INVALID_COMMAND,	nullptr,			nullptr}
+};
+
+static const clikeyword_t g_ipCommands[] =
+{
+	{"address",		CMD_ADDRESS,		nullptr,			"IPv4 address"},
+	{nullptr,		INVALID_COMMAND,	nullptr,			nullptr}
+};
+
+static const clikeyword_t g_showCommands[] =
+{
+	{"hostname",	CMD_HOSTNAME,		nullptr,			"Host name"},
+	{"interface",	CMD_INTERFACE,		g_interfaceCommands,	"Interface information"},
+	{"ip",			CMD_IP,				g_ipCommands,		"IP configuration"},
+	{"version",		CMD_VERSION,		nullptr,			"Firmware version"},
+	{nullptr,		INVALID_COMMAND,	nullptr,			nullptr}
+};
+
+static const clikeyword_t g_setCommands[] =
+{
+	{"hostname",	CMD_HOSTNAME,		g_nameArgument,		"Host name"},
+	{"name",		CMD_NAME,			g_nameArgument,		"Device name"},
+	{nullptr,		INVALID_COMMAND,	nullptr,			nullptr}
+};
+
+extern const clikeyword_t g_replayCommands[];
+const clikeyword_t g_replayCommands[] =
+{
+	{"no",			CMD_NO,				g_setCommands,		"Unset a configuration value"},
+	{"reload",		CMD_RELOAD,			nullptr,			"Restart the system"},
+	{"set",			CMD_SET,			g_setCommands,		"Set a configuration value"},
+	{"show",		CMD_SHOW,			g_showCommands,		"Print information"},
+	{nullptr,		INVALID_COMMAND,	nullptr,			nullptr}
+};
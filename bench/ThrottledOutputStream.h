@@ -0,0 +1,78 @@
+/***********************************************************************************************************************
+*                                                                                                                      *
+* embedded-cli                                                                                                         *
+*                                                                                                                      *
+* Copyright (c) 2026 Andrew D. Zonenberg and contributors                                                              *
+* All rights reserved.                                                                                                 *
+*                                                                                                                      *
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that the     *
+* following conditions are met:                                                                                        *
+*                                                                                                                      *
+*    * Redistributions of source code must retain the above copyright notice, this list of conditions, and the         *
+*      following disclaimer.                                                                                           *
+*                                                                                                                      *
+*    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       *
+*      following disclaimer in the documentation and/or other materials provided with the distribution.                *
+*                                                                                                                      *
+*    * Neither the name of the author nor the names of any contributors may be used to endorse or promote products     *
+*      derived from this software without specific prior written permission.                                           *
+*                                                                                                                      *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED   *
+* TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL *
+* THE AUTHORS BE HELD LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES        *
+* (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR       *
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT *
+* (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE       *
+* POSSIBILITY OF SUCH DAMAGE.                                                                                          *
+*                                                                                                                      *
+***********************************************************************************************************************/
+
+
+/**
+	@file
+	@brief Declaration of ThrottledOutputStream
+ */
+#ifndef ThrottledOutputStream_h
+#define ThrottledOutputStream_h
+
+#include <CLIBufferedOutputStream.h>
+
+/**
+	@brief A buffered stream over a simulated slow transport, which accepts a fixed number of bytes per tick
+ */
+template<size_t SIZE>
+class ThrottledOutputStream : public CLIBufferedOutputStreamStorage<SIZE>
+{
+public:
+	ThrottledOutputStream(size_t bytesPerTick)
+	: CLIBufferedOutputStreamStorage<SIZE>(false)
+	, m_sent(0)
+	, m_bytesPerTick(bytesPerTick)
+	, m_credit(0)
+	{}
+
+	///@brief Lets another tick's worth of data through and drains the buffer
+	void Tick()
+	{
+		m_credit = m_bytesPerTick;
+		this->Drain();
+	}
+
+	///@brief Number of bytes the transport has accepted
+	size_t m_sent;
+
+protected:
+	virtual size_t WriteToTransport(const char* /*data*/, size_t len) override
+	{
+		if(len > m_credit)
+			len = m_credit;
+		m_credit -= len;
+		m_sent += len;
+		return len;
+	}
+
+	size_t m_bytesPerTick;
+	size_t m_credit;
+};
+
+#endif